@@ -2,17 +2,45 @@
 
 
 #include "Breakable/BreakableActor.h"
+#include "Performance/SlashStats.h"
+#include "Performance/SlashMemory.h"
 
 #include "GeometryCollection/GeometryCollectionComponent.h"
+#include "GeometryCollection/GeometryCollectionObject.h"
+#include "GeometryCollection/GeometryCollection.h"
 #include "Components/CapsuleComponent.h"
 
 /** Used in GetHit_Implementation */
 #include "Items/Treasure.h"
 #include "Items/Health.h"
+#include "Breakable/DebrisSubsystem.h"
+
+/** Cached fracture playback */
+#include "Chaos/CacheManagerActor.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace
+{
+	/** Only the rigid leaves simulate: the cluster nodes above them are not pieces of their own */
+	int32 CountSimulatingPieces(const UGeometryCollection* RestCollection)
+	{
+		const TSharedPtr<FGeometryCollection, ESPMode::ThreadSafe> Collection = RestCollection->GetGeometryCollection();
+		if (!Collection.IsValid()) return 0;
+
+		int32 NumPieces = 0;
+		for (int32 Index = 0; Index < Collection->NumElements(FGeometryCollection::TransformGroup); ++Index)
+		{
+			if (Collection->IsRigid(Index)) ++NumPieces;
+		}
+		return NumPieces;
+	}
+}
 
 // Sets default values
 ABreakableActor::ABreakableActor()
 {
+	LLM_SCOPE_BYTAG(Slash_Breakables);
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it. <-
 	PrimaryActorTick.bCanEverTick = false;
 
@@ -43,24 +71,29 @@ ABreakableActor::ABreakableActor()
 // Called when the game starts or when spawned
 void ABreakableActor::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Slash_Breakables);
 	Super::BeginPlay();
 	
 }
 
 void ABreakableActor::SpawnTreasure(UWorld* World, FVector Location)
 {
+	LLM_SCOPE_BYTAG(Slash_Pickups);
 	if (World && TreasureClasses.Num() > 0)
 	{
 		const int32 Selection = FMath::RandRange(0, TreasureClasses.Num() - 1);
+		INC_DWORD_STAT(STAT_SlashSpawns);
 		World->SpawnActor<ATreasure>(TreasureClasses[Selection], Location, GetActorRotation());
 	}
 }
 
 void ABreakableActor::SpawnHealth(UWorld* World, FVector Location)
 {
+	LLM_SCOPE_BYTAG(Slash_Pickups);
 	//UWorld* World = GetWorld();
 	if (World && HealthClass)
 	{
+		INC_DWORD_STAT(STAT_SlashSpawns);
 		AHealth* SpawnedHealth = World->SpawnActor<AHealth>(HealthClass, Location, GetActorRotation());
 		if (SpawnedHealth)
 		{
@@ -78,6 +111,7 @@ void ABreakableActor::Tick(float DeltaTime)
 
 void ABreakableActor::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 {
+	LLM_SCOPE_BYTAG(Slash_Breakables);
 	/** 
 	* this will avoid the infinite loop by preventing the GetHit function from being called many times due to our
 	*  many objects being thrown around from our Geometry Collection which triggered the infinite loop safeguard.
@@ -85,6 +119,23 @@ void ABreakableActor::GetHit_Implementation(const FVector& ImpactPoint, AActor*
 	if (bBroken) return;
 	bBroken = true;
 
+	if (ShouldPlayCachedFracture(ImpactPoint))
+	{
+		FractureCache->TriggerComponent(GeometryCollection);
+		bPlayingCachedFracture = true;
+	}
+
+	/**
+	* Let the debris manager put our pieces to sleep and clean them up later.
+	* A cached fracture simulates nothing, so it's only registered for the clean up, with no pieces in the budget.
+	*/
+	UDebrisSubsystem* DebrisSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UDebrisSubsystem>() : nullptr;
+	const UGeometryCollection* RestCollection = GeometryCollection->GetRestCollection();
+	if (DebrisSubsystem && RestCollection)
+	{
+		DebrisSubsystem->RegisterDebris(this, bPlayingCachedFracture ? 0 : CountSimulatingPieces(RestCollection));
+	}
+
 	/** 
 	* We can't use GetWorld()->SpawnActor<ATreasure>() because we want to spawn an actor
 	*  based on a BP class instead of a C++ class. The BP class has things set up already like the mesh
@@ -123,4 +174,34 @@ void ABreakableActor::GetHit_Implementation(const FVector& ImpactPoint, AActor*
 	{
 		SpawnTreasure(World, Location);
 	}
-}
\ No newline at end of file
+}
+
+bool ABreakableActor::ShouldPlayCachedFracture(const FVector& ImpactPoint) const
+{
+	if (FractureCache == nullptr) return false;
+
+	/** Without a camera (e.g. dedicated server) nobody sees the difference, so always play the cache */
+	const APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	if (CameraManager && FVector::Dist(CameraManager->GetCameraLocation(), GetActorLocation()) < LiveSimulationDistance)
+	{
+		return false;
+	}
+
+	if (MaxImpactDeviation > 0.f)
+	{
+		const FVector ImpactOffset = GetActorTransform().InverseTransformPosition(ImpactPoint);
+		if (FVector::Dist(ImpactOffset, RecordedImpactOffset) > MaxImpactDeviation)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ABreakableActor::FreezeDebris()
+{
+	GeometryCollection->SetSimulatePhysics(false);
+	GeometryCollection->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Capsule->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Breakable/DebrisSubsystem.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashMemory.h"
+#include "Breakable/BreakableActor.h"
+
+/** Drop the debris far from the player first */
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Debris Subsystem Tick"), STAT_SlashDebrisTick, STATGROUP_Slash);
+
+void UDebrisSubsystem::RegisterDebris(ABreakableActor* Breakable, int32 NumPieces)
+{
+	LLM_SCOPE_BYTAG(Slash_Breakables);
+	if (Breakable == nullptr) return;
+
+	FDebrisEntry& Entry = Debris.AddDefaulted_GetRef();
+	Entry.Breakable = Breakable;
+	Entry.BrokenTime = GetWorld()->GetTimeSeconds();
+	Entry.NumPieces = NumPieces;
+	NumSimulatingPieces += NumPieces;
+
+	// Don't wait for the next update: a wave of broken pots must not go over budget even for a moment
+	EnforceBudget();
+}
+
+void UDebrisSubsystem::Tick(float DeltaTime)
+{
+	SLASH_SCOPE(SPB_Debris, DebrisTick);
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval) return;
+	TimeSinceUpdate = 0.f;
+
+	ExpireDebris(GetWorld()->GetTimeSeconds());
+	EnforceBudget();
+}
+
+TStatId UDebrisSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDebrisSubsystem, STATGROUP_Tickables);
+}
+
+bool UDebrisSubsystem::IsTickable() const
+{
+	// Nothing broken, nothing to do
+	return Debris.Num() > 0;
+}
+
+void UDebrisSubsystem::ExpireDebris(float Now)
+{
+	for (int32 Index = Debris.Num() - 1; Index >= 0; --Index)
+	{
+		FDebrisEntry& Entry = Debris[Index];
+		ABreakableActor* Breakable = Entry.Breakable.Get();
+		const float Age = Now - Entry.BrokenTime;
+
+		if (Breakable && Entry.State == EDebrisState::EDS_Simulating && Age >= SleepAfter)
+		{
+			SleepDebris(Entry);
+		}
+
+		if (Breakable == nullptr || Age >= ExpireAfter)
+		{
+			if (Entry.State == EDebrisState::EDS_Simulating)
+			{
+				NumSimulatingPieces -= Entry.NumPieces;
+			}
+			if (Breakable && bRemoveExpiredDebris)
+			{
+				Breakable->Destroy();
+			}
+
+			// A frozen breakable costs nothing anymore, so we stop tracking it either way
+			Debris.RemoveAtSwap(Index);
+		}
+	}
+}
+
+void UDebrisSubsystem::EnforceBudget()
+{
+	if (NumSimulatingPieces <= MaxSimulatingPieces) return;
+
+	/**
+	* Sort the simulating debris from the farthest to the closest to the player, then put them to sleep until
+	*  we're back under budget. Without a player (e.g. dedicated server) the oldest debris goes first.
+	*/
+	const APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+	const FVector PlayerLocation = Player ? Player->GetActorLocation() : FVector::ZeroVector;
+
+	TArray<int32> Candidates;
+	for (int32 Index = 0; Index < Debris.Num(); ++Index)
+	{
+		// Entries without pieces (cached fractures) cost nothing, freezing them wouldn't help
+		if (Debris[Index].State == EDebrisState::EDS_Simulating && Debris[Index].NumPieces > 0 && Debris[Index].Breakable.IsValid())
+		{
+			Candidates.Add(Index);
+		}
+	}
+
+	Candidates.Sort([this, Player, &PlayerLocation](int32 A, int32 B)
+	{
+		if (Player == nullptr)
+		{
+			return Debris[A].BrokenTime < Debris[B].BrokenTime;
+		}
+		return FVector::DistSquared(Debris[A].Breakable->GetActorLocation(), PlayerLocation) >
+			FVector::DistSquared(Debris[B].Breakable->GetActorLocation(), PlayerLocation);
+	});
+
+	for (int32 Index : Candidates)
+	{
+		if (NumSimulatingPieces <= MaxSimulatingPieces) break;
+		SleepDebris(Debris[Index]);
+	}
+}
+
+void UDebrisSubsystem::SleepDebris(FDebrisEntry& Entry)
+{
+	if (Entry.State != EDebrisState::EDS_Simulating) return;
+
+	Entry.State = EDebrisState::EDS_Sleeping;
+	NumSimulatingPieces -= Entry.NumPieces;
+
+	if (ABreakableActor* Breakable = Entry.Breakable.Get())
+	{
+		Breakable->FreezeDebris();
+	}
+}
@@ -2,6 +2,8 @@
 
 
 #include "Characters/BaseCharacter.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashTrace.h"
 
 /** To set the weapon's collision enabled */
 #include "Components/BoxComponent.h"
@@ -12,21 +14,26 @@
 
 /** Use our custom actor component */
 #include "Components/AttributeComponent.h"
+#include "Components/HurtboxComponent.h"
+#include "Components/MontagePlayerComponent.h"
 
 /** Play sound, Spawn Cascade Particles emitter */
 #include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
 
-void ABaseCharacter::PlayMontageSection(UAnimMontage* Montage, const FName& SectionName)
+/** AttackEnd fallback */
+#include "Combat/AttackFrameData.h"
+#include "Animation/AnimMontage.h"
+
+DECLARE_CYCLE_STAT(TEXT("Character HandleDamage"), STAT_SlashHandleDamage, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Character Hit Particles"), STAT_SlashHitParticles, STATGROUP_Slash);
+
+void ABaseCharacter::PlayMontageSection(EMontageType Type, const FName& SectionName)
 {
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && Montage)
-	{
-		AnimInstance->Montage_Play(Montage);
-		AnimInstance->Montage_JumpToSection(SectionName, Montage);
-	}
+	MontagePlayer->Play(Type, SectionName);
 }
 
-int32 ABaseCharacter::PlayRandomMontageSection(UAnimMontage* Montage, const TArray<FName>& SectionNames)
+int32 ABaseCharacter::PlayRandomMontageSection(EMontageType Type, const TArray<FName>& SectionNames)
 {
 	/** 
 	* Since this function must return a value, if SectionNames is empty, we'll return -1 because we
@@ -37,7 +44,7 @@ int32 ABaseCharacter::PlayRandomMontageSection(UAnimMontage* Montage, const TArr
 	const int32 MaxSectionIndex = SectionNames.Num() - 1;
 	const int32 Selection = FMath::RandRange(0, MaxSectionIndex);
 
-	PlayMontageSection(Montage, SectionNames[Selection]);
+	PlayMontageSection(Type, SectionNames[Selection]);
 
 	return Selection;
 }
@@ -45,11 +52,18 @@ int32 ABaseCharacter::PlayRandomMontageSection(UAnimMontage* Montage, const TArr
 void ABaseCharacter::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	MontagePlayer->RegisterMontage(EMontageType::EMT_Attack, AttackMontage);
+	MontagePlayer->RegisterMontage(EMontageType::EMT_HitReact, HitReactMontage);
+	MontagePlayer->RegisterMontage(EMontageType::EMT_Death, DeathMontage);
+	MontagePlayer->RegisterMontage(EMontageType::EMT_Dodge, DodgeMontage);
 }
 
 void ABaseCharacter::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 {
+	// A hit interrupts the attack, the fallback must not end the hit react (or the death) for it
+	GetWorldTimerManager().ClearTimer(AttackEndFallbackTimer);
+
 	if (IsAlive() && Hitter)
 	{
 		DirectionalHitReact(Hitter->GetActorLocation());
@@ -90,6 +104,8 @@ void ABaseCharacter::Die_Implementation()
 	* If it's alive, CombatTarget should be set to null.
 	*/
 	Tags.Add(FName("Dead"));
+	GetWorldTimerManager().ClearTimer(AttackEndFallbackTimer);
+	SLASH_TRACE_BOOKMARK(TEXT("Death %s"), *GetName());
 	PlayDeathMontage();
 }
 
@@ -141,6 +157,7 @@ void ABaseCharacter::DirectionalHitReact(const FVector& ImpactPoint)
 
 void ABaseCharacter::HandleDamage(float DamageAmount)
 {
+	SLASH_SCOPE(SPB_Combat, HandleDamage);
 	/** 
 	* This won't change the HealthBarWidget as not all children will have one, but all classes
 	*  will have attributes that receive damage.
@@ -166,16 +183,19 @@ void ABaseCharacter::PlayHitSound(const FVector& ImpactPoint)
 
 void ABaseCharacter::SpawnHitParticles(const FVector& ImpactPoint)
 {
+	SLASH_SCOPE(SPB_FX, HitParticles);
 	/**
 	* Spawn an Emitter at location, using our HitParticles
 	*/
 	if (HitParticles && GetWorld())
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(
+		INC_DWORD_STAT(STAT_SlashSpawns);
+		UParticleSystemComponent* Particles = UGameplayStatics::SpawnEmitterAtLocation(
 			GetWorld(),
 			HitParticles,
 			ImpactPoint
 		);
+		SLASH_TRACE_FX(Particles);
 	}
 }
 
@@ -192,27 +212,45 @@ void ABaseCharacter::DisableMeshAndCapsuleCollision()
 
 void ABaseCharacter::PlayHitReactMontage(const FName& SectionName)
 {
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && HitReactMontage)
-	{
-		AnimInstance->Montage_Play(HitReactMontage);
-		AnimInstance->Montage_JumpToSection(SectionName, HitReactMontage);
-	}
+	MontagePlayer->PlayHitReact(SectionName);
 }
 
 void ABaseCharacter::PlaySingleAttackMontage(const FName& SectionName)
 {
-	PlayMontageSection(AttackMontage, SectionName);
+	MontagePlayer->PlayAttack(SectionName);
+	ScheduleAttackEndFallback(SectionName);
 }
 
 int32 ABaseCharacter::PlayAttackMontage()
 {
-	return PlayRandomMontageSection(AttackMontage, AttackMontageSections);
+	const int32 Selection = PlayRandomMontageSection(EMontageType::EMT_Attack, AttackMontageSections);
+	if (Selection >= 0)
+	{
+		ScheduleAttackEndFallback(AttackMontageSections[Selection]);
+	}
+	return Selection;
+}
+
+void ABaseCharacter::ScheduleAttackEndFallback(const FName& SectionName)
+{
+	const FAttackFrameEntry* Entry = FrameData ? FrameData->FindEntry(AttackMontage, SectionName) : nullptr;
+	if (Entry == nullptr || !Entry->HasActionEnd()) return;
+
+	/** A little later than the notify so that, when it does arrive, it's always the notify that ends the attack */
+	const float FallbackDelay = 0.1f;
+	const float PlayRate = FMath::Max(AttackMontage->RateScale, KINDA_SMALL_NUMBER);
+	const float Delay = (Entry->ActionEnd - Entry->SectionStart) / PlayRate + FallbackDelay;
+	GetWorldTimerManager().SetTimer(AttackEndFallbackTimer, this, &ABaseCharacter::AttackEndFallback, Delay);
+}
+
+void ABaseCharacter::AttackEndFallback()
+{
+	AttackEnd();
 }
 
 int32 ABaseCharacter::PlayDeathMontage()
 {
-	const int32 Selection = PlayRandomMontageSection(DeathMontage, DeathMontageSections);
+	const int32 Selection = PlayRandomMontageSection(EMontageType::EMT_Death, DeathMontageSections);
 	TEnumAsByte<EDeathPose> Pose{ Selection };
 	if (Pose < EDeathPose::EDP_MAX)
 	{
@@ -224,16 +262,16 @@ int32 ABaseCharacter::PlayDeathMontage()
 
 void ABaseCharacter::PlayDodgeMontage()
 {
-	PlayMontageSection(DodgeMontage, FName("Default"));
+	static const FName DodgeSectionName("Default");
+	MontagePlayer->PlayDodge(DodgeSectionName);
 }
 
 void ABaseCharacter::StopAttackMontage()
 {
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance)
-	{
-		AnimInstance->Montage_Stop(0.25, AttackMontage);
-	}
+	// The attack was interrupted, its AttackEnd won't come
+	GetWorldTimerManager().ClearTimer(AttackEndFallbackTimer);
+
+	MontagePlayer->Stop(EMontageType::EMT_Attack, 0.25f);
 }
 
 FVector ABaseCharacter::GetTranslationWarpTarget()
@@ -275,6 +313,7 @@ FVector ABaseCharacter::GetRotationWarpTarget()
 
 void ABaseCharacter::AttackEnd()
 {
+	GetWorldTimerManager().ClearTimer(AttackEndFallbackTimer);
 }
 
 void ABaseCharacter::DodgeEnd()
@@ -290,16 +329,38 @@ void ABaseCharacter::SetWeaponCollisionEnabled(ECollisionEnabled::Type Collision
 		EquippedWeapon->GetWeaponBox()->SetCollisionEnabled(CollisionEnabled);
 		// Clear the TArray with actors to ignore!
 		EquippedWeapon->IgnoreActors.Empty();
+
+		if (CollisionEnabled == ECollisionEnabled::NoCollision)
+		{
+			EquippedWeapon->EndBakedSwing();
+		}
+		else if (BladeTrajectories)
+		{
+			EquippedWeapon->BeginBakedSwing(BladeTrajectories, GetMesh());
+		}
 	}
 }
 
-ABaseCharacter::ABaseCharacter()
+void ABaseCharacter::GetCombatMontages(TArray<UAnimMontage*>& OutMontages) const
+{
+	OutMontages.Add(AttackMontage);
+	OutMontages.Add(HitReactMontage);
+	OutMontages.Add(DeathMontage);
+	OutMontages.Add(DodgeMontage);
+}
+
+ABaseCharacter::ABaseCharacter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	PrimaryActorTick.bCanEverTick = true;
 
 	// Construct Attributes component
 	Attributes = CreateDefaultSubobject<UAttributeComponent>(TEXT("Attributes"));
 
+	// Construct Hurtboxes component. It stays empty (and weapons fall back to box traces) until a profile is set
+	Hurtboxes = CreateDefaultSubobject<UHurtboxComponent>(TEXT("Hurtboxes"));
+
+	MontagePlayer = CreateDefaultSubobject<UMontagePlayerComponent>(TEXT("MontagePlayer"));
+
 	// Disable collision for the camera
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 
@@ -2,9 +2,12 @@
 
 
 #include "Characters/SlashAnimInstance.h"
+#include "Performance/SlashPerfCounters.h"
 #include "Characters/SlashCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
-#include "Kismet/KismetMathLibrary.h"
+
+DECLARE_CYCLE_STAT(TEXT("Echo Anim Snapshot"), STAT_SlashEchoAnimSnapshot, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Echo Anim Update (worker)"), STAT_SlashEchoAnimUpdate, STATGROUP_Slash);
 
 void USlashAnimInstance::NativeInitializeAnimation()
 {
@@ -19,22 +22,39 @@ void USlashAnimInstance::NativeInitializeAnimation()
 
 void USlashAnimInstance::NativeUpdateAnimation(float DeltaTime)
 {
+   SLASH_SCOPE(SPB_Animation, EchoAnimSnapshot);
    Super::NativeUpdateAnimation(DeltaTime);
 
-   if (SlashCharacterMovement)
+   /** Game thread: only copy, no math */
+   bHasSnapshot = SlashCharacterMovement != nullptr;
+   if (bHasSnapshot)
    {
-      GroundSpeed = UKismetMathLibrary::VSizeXY(SlashCharacterMovement->Velocity);
+      Snapshot.Velocity = SlashCharacterMovement->Velocity;
+      Snapshot.Rotation = SlashCharacter->GetActorRotation();
+      Snapshot.bLocked = SlashCharacter->bLocked;
+      Snapshot.bIsEnemy = SlashCharacter->bIsEnemy;
+      Snapshot.bIsFalling = SlashCharacterMovement->IsFalling();
+      Snapshot.CharacterState = SlashCharacter->GetCharacterState();
+      Snapshot.ActionState = SlashCharacter->GetActionState();
+      Snapshot.DeathPose = SlashCharacter->GetDeathPose();
+   }
+}
 
-      const FVector SlashVelocity = SlashCharacter->GetVelocity();
-      const FRotator SlashRotation = SlashCharacter->GetActorRotation();
-      Direction = CalculateDirection(SlashVelocity, SlashRotation);
+void USlashAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaTime)
+{
+   SCOPE_CYCLE_COUNTER(STAT_SlashEchoAnimUpdate);
+   Super::NativeThreadSafeUpdateAnimation(DeltaTime);
 
-      bIsLocked = SlashCharacter->bLocked;
-      bIsEnemy = SlashCharacter->bIsEnemy;
+   if (!bHasSnapshot) return;
 
-      IsFalling = SlashCharacterMovement->IsFalling();
-      CharacterState = SlashCharacter->GetCharacterState();
-      ActionState = SlashCharacter->GetActionState();
-      DeathPose = SlashCharacter->GetDeathPose();
-   }
+   GroundSpeed = Snapshot.Velocity.Size2D();
+   Direction = CalculateDirection(Snapshot.Velocity, Snapshot.Rotation);
+
+   bIsLocked = Snapshot.bLocked;
+   bIsEnemy = Snapshot.bIsEnemy;
+
+   IsFalling = Snapshot.bIsFalling;
+   CharacterState = Snapshot.CharacterState;
+   ActionState = Snapshot.ActionState;
+   DeathPose = Snapshot.DeathPose;
 }
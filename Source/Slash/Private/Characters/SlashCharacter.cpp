@@ -2,6 +2,7 @@
 
 
 #include "Characters/SlashCharacter.h"
+#include "Performance/SlashPerfCounters.h"
 
 /** Hair and Eyebrow  */
 #include "GroomComponent.h"
@@ -25,8 +26,15 @@
 #include "Items/Item.h"
 #include "Items/Weapons/Weapon.h"
 
+/** Find the items in pickup range */
+#include "Items/PickupSubsystem.h"
+#include "Components/SoulMagnetComponent.h"
+#include "Components/InputReplayComponent.h"
+#include "Components/CapsuleComponent.h"
+
 /** For using Animation Montage in Attack() */
 #include "Animation/AnimMontage.h"
+#include "Components/MontagePlayerComponent.h"
 
 /** Pawn Sensing component */
 #include "Perception/PawnSensingComponent.h"
@@ -56,6 +64,10 @@
 /** Used in SpeedUp */
 #include "Kismet/KismetMathLibrary.h"
 
+DECLARE_CYCLE_STAT(TEXT("Echo TakeDamage"), STAT_SlashEchoTakeDamage, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Echo Nearby Pickups"), STAT_SlashEchoNearbyPickups, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Echo HUD Setters"), STAT_SlashEchoHUDSetters, STATGROUP_Slash);
+
 void ASlashCharacter::InitializeSlashOverlay(APlayerController* PlayerController)
 {
 	ASlashHUD* SlashHUD = Cast<ASlashHUD>(PlayerController->GetHUD());
@@ -75,6 +87,7 @@ void ASlashCharacter::InitializeSlashOverlay(APlayerController* PlayerController
 
 void ASlashCharacter::SetHUDHealth()
 {
+	SLASH_SCOPE(SPB_HUD, EchoHUDSetters);
 	//if (SlashOverlay && Attributes) // the functions that calls this one already checks Attributes && SlashOverlay
 	//{
 	//	
@@ -84,6 +97,7 @@ void ASlashCharacter::SetHUDHealth()
 
 void ASlashCharacter::SetHUDStamina()
 {
+	SLASH_SCOPE(SPB_HUD, EchoHUDSetters);
 	//if (Attributes && SlashOverlay) // the functions that calls this one already checks Attributes && SlashOverlay
 	//{
 	//	SlashOverlay->SetStaminaBarPercent(Attributes->GetStaminaPercent());
@@ -129,6 +143,8 @@ void ASlashCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
+	MontagePlayer->RegisterMontage(EMontageType::EMT_Equip, EquipMontage);
+
 	APlayerController* PlayerController = Cast<APlayerController>(GetController()); //Controller);
 	if (PlayerController)
 	{
@@ -369,6 +385,8 @@ void ASlashCharacter::EquipWeapon(AWeapon* Weapon)
 
 void ASlashCharacter::AttackEnd()
 {
+	Super::AttackEnd();
+
 	ActionState = EActionState::EAS_Unoccupied;
 }
 
@@ -406,12 +424,7 @@ bool ASlashCharacter::CanDodge()
 
 void ASlashCharacter::PlayEquipMontage(FName SectionName)
 {
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && EquipMontage)
-	{
-		AnimInstance->Montage_Play(EquipMontage);
-		AnimInstance->Montage_JumpToSection(SectionName, EquipMontage);
-	}
+	MontagePlayer->PlayEquip(SectionName);
 }
 
 bool ASlashCharacter::CanDisarm()
@@ -431,7 +444,8 @@ bool ASlashCharacter::CanArm()
 
 void ASlashCharacter::Disarm()
 {
-	PlayEquipMontage(FName("Unequip"));
+	static const FName UnequipSectionName("Unequip");
+	PlayEquipMontage(UnequipSectionName);
 	CharacterState = ECharacterState::ECS_Unequipped;
 	ActionState = EActionState::EAS_EquippingWeapon;
 	UnlockFromTarget();
@@ -439,7 +453,8 @@ void ASlashCharacter::Disarm()
 
 void ASlashCharacter::Arm()
 {
-	PlayEquipMontage(FName("Equip"));
+	static const FName EquipSectionName("Equip");
+	PlayEquipMontage(EquipSectionName);
 	CharacterState = ECharacterState::ECS_EquippedOneHandedWeapon;
 	ActionState = EActionState::EAS_EquippingWeapon;
 }
@@ -507,6 +522,9 @@ ASlashCharacter::ASlashCharacter()
 	Eyebrows = CreateDefaultSubobject<UGroomComponent>(TEXT("Eyebrows"));
 	Eyebrows->SetupAttachment(GetMesh());
 	Eyebrows->AttachmentName = FString("head");
+
+	SoulMagnet = CreateDefaultSubobject<USoulMagnetComponent>(TEXT("SoulMagnet"));
+	InputReplay = CreateDefaultSubobject<UInputReplayComponent>(TEXT("InputReplay"));
 }
 
 void ASlashCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -515,18 +533,46 @@ void ASlashCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComp
 
 	if (UEnhancedInputComponent* EnhancedInputComponent = CastChecked<UEnhancedInputComponent>(PlayerInputComponent))
 	{
-		EnhancedInputComponent->BindAction(MovementAction, ETriggerEvent::Triggered, this, &ASlashCharacter::Move);
-		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &ASlashCharacter::Look);
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Triggered, this, &ASlashCharacter::Jump);
-		EnhancedInputComponent->BindAction(EquipAction, ETriggerEvent::Triggered, this, &ASlashCharacter::EKeyPressed);
-		EnhancedInputComponent->BindAction(LeftAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::LeftButtonAttack);
-		EnhancedInputComponent->BindAction(OneKeyAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::OneKeyAttack);
-		EnhancedInputComponent->BindAction(TwoKeyAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::TwoKeyAttack);
-		EnhancedInputComponent->BindAction(ThreeKeyAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::ThreeKeyAttack);
-		EnhancedInputComponent->BindAction(LockOnTarget, ETriggerEvent::Started, this, &ASlashCharacter::LockTarget);
-		EnhancedInputComponent->BindAction(DodgeIA, ETriggerEvent::Started, this, &ASlashCharacter::Dodge);
-		EnhancedInputComponent->BindAction(SpeedUpAction, ETriggerEvent::Triggered, this, &ASlashCharacter::SpeedUp);
-		EnhancedInputComponent->BindAction(SpeedUpAction, ETriggerEvent::Completed, this, &ASlashCharacter::EndSpeedUp);
+		EnhancedInputComponent->BindAction(MovementAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_Move);
+		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_Look);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_Jump);
+		EnhancedInputComponent->BindAction(EquipAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_Equip);
+		EnhancedInputComponent->BindAction(LeftAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_LeftAttack);
+		EnhancedInputComponent->BindAction(OneKeyAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_OneKeyAttack);
+		EnhancedInputComponent->BindAction(TwoKeyAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_TwoKeyAttack);
+		EnhancedInputComponent->BindAction(ThreeKeyAttackAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_ThreeKeyAttack);
+		EnhancedInputComponent->BindAction(LockOnTarget, ETriggerEvent::Started, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_LockTarget);
+		EnhancedInputComponent->BindAction(DodgeIA, ETriggerEvent::Started, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_Dodge);
+		EnhancedInputComponent->BindAction(SpeedUpAction, ETriggerEvent::Triggered, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_SpeedUp);
+		EnhancedInputComponent->BindAction(SpeedUpAction, ETriggerEvent::Completed, this, &ASlashCharacter::HandleInputAction, ESlashInputAction::ESIA_EndSpeedUp);
+	}
+}
+
+void ASlashCharacter::HandleInputAction(const FInputActionValue& Value, ESlashInputAction Action)
+{
+	if (InputReplay->IsPlaying()) return;
+
+	InputReplay->RecordAction(Action, Value);
+	DispatchInputAction(Action, Value);
+}
+
+void ASlashCharacter::DispatchInputAction(ESlashInputAction Action, const FInputActionValue& Value)
+{
+	switch (Action)
+	{
+	case ESlashInputAction::ESIA_Move: Move(Value); break;
+	case ESlashInputAction::ESIA_Look: Look(Value); break;
+	case ESlashInputAction::ESIA_Jump: Jump(); break;
+	case ESlashInputAction::ESIA_Equip: EKeyPressed(); break;
+	case ESlashInputAction::ESIA_LeftAttack: LeftButtonAttack(); break;
+	case ESlashInputAction::ESIA_OneKeyAttack: OneKeyAttack(); break;
+	case ESlashInputAction::ESIA_TwoKeyAttack: TwoKeyAttack(); break;
+	case ESlashInputAction::ESIA_ThreeKeyAttack: ThreeKeyAttack(); break;
+	case ESlashInputAction::ESIA_LockTarget: LockTarget(); break;
+	case ESlashInputAction::ESIA_Dodge: Dodge(); break;
+	case ESlashInputAction::ESIA_SpeedUp: SpeedUp(Value); break;
+	case ESlashInputAction::ESIA_EndSpeedUp: EndSpeedUp(Value); break;
+	default: break;
 	}
 }
 
@@ -534,7 +580,10 @@ void ASlashCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (Attributes && SlashOverlay)
+	UpdateNearbyPickups();
+
+	// Nothing to regenerate (nor to show) while stamina is full
+	if (Attributes && SlashOverlay && !Attributes->IsStaminaFull())
 	{
 		Attributes->RegenStamina(DeltaTime);
 		SetHUDStamina();
@@ -559,6 +608,7 @@ void ASlashCharacter::Tick(float DeltaTime)
 
 float ASlashCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	SLASH_SCOPE(SPB_Combat, EchoTakeDamage);
 	HandleDamage(DamageAmount);
 	if (Attributes && SlashOverlay)
 	{
@@ -588,16 +638,64 @@ void ASlashCharacter::GetHit_Implementation(const FVector& ImpactPoint, AActor*
 	
 }
 
+void ASlashCharacter::GetCombatMontages(TArray<UAnimMontage*>& OutMontages) const
+{
+	Super::GetCombatMontages(OutMontages);
+	OutMontages.Add(EquipMontage);
+}
+
+void ASlashCharacter::UpdateNearbyPickups()
+{
+	SLASH_SCOPE(SPB_Pickups, EchoNearbyPickups);
+	UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>();
+	if (Pickups == nullptr || (Pickups->GetNumPickups() == 0 && NearbyPickups.Num() == 0)) return;
+
+	/** The capsule as a segment (the centers of its hemispheres) plus a radius */
+	const UCapsuleComponent* Capsule = GetCapsuleComponent();
+	const FVector Center = Capsule->GetComponentLocation();
+	const FVector HalfSegment = Capsule->GetUpVector() * Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+	TArray<AItem*> InRange;
+	Pickups->QueryPickups(Center - HalfSegment, Center + HalfSegment, Capsule->GetScaledCapsuleRadius(), InRange);
+
+	/** Out of range first, so walking from a weapon to another ends with the new one as OverlappingItem */
+	TArray<TWeakObjectPtr<AItem>> PreviousPickups = MoveTemp(NearbyPickups);
+	for (const TWeakObjectPtr<AItem>& Previous : PreviousPickups)
+	{
+		AItem* Item = Previous.Get();
+		if (Item && !InRange.Contains(Item))
+		{
+			Item->NotifyPickupExit(this);
+		}
+	}
+
+	// Picking up may destroy the item, so keep track of it before notifying
+	NearbyPickups.Reserve(InRange.Num());
+	for (AItem* Item : InRange)
+	{
+		NearbyPickups.Add(Item);
+		if (!PreviousPickups.Contains(Item))
+		{
+			Item->NotifyPickupEnter(this);
+		}
+	}
+}
+
 void ASlashCharacter::SetOverlappingItem(AItem* Item)
 {
 	OverlappingItem = Item;
 }
 
 void ASlashCharacter::AddSouls(ASoul* Soul) // Override from IPickupInterface; it'll be called from Soul class when it's picked up
+{
+	CollectSouls(Soul->GetSouls());
+}
+
+void ASlashCharacter::CollectSouls(int32 NumberOfSouls)
 {
 	if (Attributes && SlashOverlay)
 	{
-		Attributes->AddSouls(Soul->GetSouls());
+		Attributes->AddSouls(NumberOfSouls);
 		SlashOverlay->SetSouls(Attributes->GetSouls());
 	}
 }
@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/AttackFrameData.h"
+#include "Animation/AnimMontage.h"
+
+const FAttackFrameEntry* UAttackFrameDataTable::FindEntry(const UAnimMontage* Montage, const FName& SectionName) const
+{
+	if (Montage == nullptr) return nullptr;
+
+	const FSoftObjectPath MontagePath(Montage);
+	return Entries.FindByPredicate([&MontagePath, &SectionName](const FAttackFrameEntry& Entry)
+	{
+		return Entry.SectionName == SectionName && Entry.Montage.ToSoftObjectPath() == MontagePath;
+	});
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/BladeTrajectoryAsset.h"
+
+#if WITH_EDITOR
+/** Sample the montage animations */
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequence.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+
+/** Read TraceStart/TraceEnd from the weapon */
+#include "Items/Weapons/Weapon.h"
+#endif
+
+const FBakedBladeSection* UBladeTrajectoryAsset::FindSection(const FName& SectionName) const
+{
+	return Sections.FindByPredicate([&SectionName](const FBakedBladeSection& Section)
+	{
+		return Section.SectionName == SectionName;
+	});
+}
+
+#if WITH_EDITOR
+namespace
+{
+	/**
+	* Component space transform of MeshBoneIndex at AnimTime, walking up the parents and composing their local
+	*  transforms. The root bone is skipped for root motion animations since the character moves instead.
+	*/
+	FTransform GetComponentSpaceBoneTransform(const UAnimSequence* Sequence, const USkeletalMesh* Mesh, int32 MeshBoneIndex, double AnimTime)
+	{
+		const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+		const USkeleton* Skeleton = Sequence->GetSkeleton();
+
+		FTransform ComponentSpace = FTransform::Identity;
+		for (int32 BoneIndex = MeshBoneIndex; BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+		{
+			if (BoneIndex == 0 && Sequence->bEnableRootMotion) break;
+
+			FTransform Local = RefSkeleton.GetRefBonePose()[BoneIndex];
+			const int32 SkeletonBoneIndex = Skeleton ? Skeleton->GetSkeletonBoneIndexFromMeshBoneIndex(Mesh, BoneIndex) : INDEX_NONE;
+			if (SkeletonBoneIndex != INDEX_NONE)
+			{
+				Sequence->GetBoneTransform(Local, FSkeletonPoseBoneIndex(SkeletonBoneIndex), AnimTime, false);
+			}
+
+			ComponentSpace = ComponentSpace * Local;
+		}
+
+		return ComponentSpace;
+	}
+}
+
+void UBladeTrajectoryAsset::Bake()
+{
+	if (Montage == nullptr || Mesh == nullptr || WeaponClass == nullptr || Montage->SlotAnimTracks.Num() == 0) return;
+
+	const USkeletalMeshSocket* Socket = Mesh->FindSocket(WeaponSocketName);
+	const AWeapon* Weapon = WeaponClass->GetDefaultObject<AWeapon>();
+	if (Socket == nullptr || Weapon->GetTraceStart() == nullptr || Weapon->GetTraceEnd() == nullptr) return;
+
+	const int32 SocketBoneIndex = Mesh->GetRefSkeleton().FindBoneIndex(Socket->BoneName);
+	if (SocketBoneIndex == INDEX_NONE) return;
+
+	/**
+	* Equip() snaps the weapon's root to the socket, so TraceStart and TraceEnd relative locations are offsets
+	*  from the socket.
+	*/
+	const FVector BladeStartOffset = Weapon->GetTraceStart()->GetRelativeLocation();
+	const FVector BladeEndOffset = Weapon->GetTraceEnd()->GetRelativeLocation();
+	const FTransform SocketLocal = Socket->GetSocketLocalTransform();
+
+	const FAnimTrack& Track = Montage->SlotAnimTracks[0].AnimTrack;
+	const float SampleInterval = 1.f / SampleRate;
+
+	Sections.Reset();
+	for (int32 SectionIndex = 0; SectionIndex < Montage->CompositeSections.Num(); ++SectionIndex)
+	{
+		float StartTime = 0.f;
+		float EndTime = 0.f;
+		Montage->GetSectionStartAndEndTime(SectionIndex, StartTime, EndTime);
+
+		FBakedBladeSection& Baked = Sections.AddDefaulted_GetRef();
+		Baked.SectionName = Montage->GetSectionName(SectionIndex);
+		Baked.StartTime = StartTime;
+		Baked.SampleInterval = SampleInterval;
+
+		// Times computed like GetSampleTime(), not accumulated, so the last sample of the section isn't lost to float error
+		const int32 NumSamples = FMath::FloorToInt((EndTime - StartTime) / SampleInterval + KINDA_SMALL_NUMBER) + 1;
+		Baked.BladeStart.Reserve(NumSamples);
+		Baked.BladeEnd.Reserve(NumSamples);
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			const float Time = Baked.GetSampleTime(SampleIndex);
+			const FAnimSegment* Segment = Track.GetSegmentAtTime(Time);
+			const UAnimSequence* Sequence = Segment ? Cast<UAnimSequence>(Segment->GetAnimReference()) : nullptr;
+			if (Sequence == nullptr)
+			{
+				// Keep the samples evenly spaced even if there's a gap in the track
+				const bool bHasPrevious = Baked.NumSamples() > 0;
+				Baked.BladeStart.Add(bHasPrevious ? Baked.BladeStart.Last() : FVector3f::ZeroVector);
+				Baked.BladeEnd.Add(bHasPrevious ? Baked.BladeEnd.Last() : FVector3f::ZeroVector);
+				continue;
+			}
+
+			const double AnimTime = Segment->ConvertTrackPosToAnimPos(Time);
+			const FTransform Bone = GetComponentSpaceBoneTransform(Sequence, Mesh, SocketBoneIndex, AnimTime);
+			const FTransform SocketTransform = SocketLocal * Bone;
+
+			Baked.BladeStart.Add(FVector3f(SocketTransform.TransformPosition(BladeStartOffset)));
+			Baked.BladeEnd.Add(FVector3f(SocketTransform.TransformPosition(BladeEndOffset)));
+		}
+	}
+
+	MarkPackageDirty();
+}
+#endif
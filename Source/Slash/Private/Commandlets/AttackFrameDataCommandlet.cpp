@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/AttackFrameDataCommandlet.h"
+
+/** Find and load the character Blueprints */
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Characters/BaseCharacter.h"
+
+/** Read the notifies */
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+
+/** Save the table asset */
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "Misc/PackageName.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAttackFrameData, Log, All);
+
+namespace
+{
+	/** Skeleton notifies only have a name, notify objects (sounds, custom notifies...) name themselves */
+	FName GetNotifyName(const FAnimNotifyEvent& Event)
+	{
+		if (Event.Notify)
+		{
+			return FName(*Event.Notify->GetNotifyName());
+		}
+		return Event.NotifyName;
+	}
+}
+
+UAttackFrameDataCommandlet::UAttackFrameDataCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAttackFrameDataCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString OutputPackage = TEXT("/Game/Data/DA_AttackFrameData");
+	FParse::Value(*Params, TEXT("Output="), OutputPackage);
+
+	FString NotifyName;
+	if (FParse::Value(*Params, TEXT("HitStartNotify="), NotifyName)) HitStartNotify = FName(*NotifyName);
+	if (FParse::Value(*Params, TEXT("HitEndNotify="), NotifyName)) HitEndNotify = FName(*NotifyName);
+	const bool bSave = !FParse::Param(*Params, TEXT("NoSave"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FAssetData> BlueprintAssets;
+	AssetRegistry.GetAssetsByClass(UBlueprint::StaticClass()->GetClassPathName(), BlueprintAssets, true);
+
+	TArray<FAttackFrameEntry> Entries;
+	TSet<UAnimMontage*> VisitedMontages;
+
+	for (const FAssetData& Asset : BlueprintAssets)
+	{
+		UBlueprint* Blueprint = Cast<UBlueprint>(Asset.GetAsset());
+		if (Blueprint == nullptr || Blueprint->GeneratedClass == nullptr || !Blueprint->GeneratedClass->IsChildOf(ABaseCharacter::StaticClass())) continue;
+
+		const ABaseCharacter* Character = Blueprint->GeneratedClass->GetDefaultObject<ABaseCharacter>();
+		const FString Owner = Blueprint->GetName();
+
+		TArray<UAnimMontage*> Montages;
+		Character->GetCombatMontages(Montages);
+		for (UAnimMontage* Montage : Montages)
+		{
+			// Montages shared by many characters (e.g. enemy variants) are only extracted once
+			if (Montage == nullptr || VisitedMontages.Contains(Montage)) continue;
+			VisitedMontages.Add(Montage);
+
+			ExtractMontage(Montage, Owner, Entries);
+
+			// Attack montages must open and close a hit window and tell us when the attack ends
+			if (Montage == Character->GetAttackMontage())
+			{
+				for (const FAttackFrameEntry& Entry : Entries)
+				{
+					if (Entry.Montage.Get() != Montage) continue;
+					if (!Entry.HasHitWindow()) ReportError(Owner, Montage, Entry.SectionName, TEXT("attack section has no weapon collision window"));
+					if (!Entry.HasActionEnd()) ReportError(Owner, Montage, Entry.SectionName, TEXT("attack section has no AttackEnd notify"));
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogAttackFrameData, Display, TEXT("Extracted %d sections from %d montages, %d inconsistencies"), Entries.Num(), VisitedMontages.Num(), NumErrors);
+
+	if (bSave)
+	{
+		const FString AssetName = FPackageName::GetLongPackageAssetName(OutputPackage);
+		UPackage* Package = FPackageName::DoesPackageExist(OutputPackage) ? LoadPackage(nullptr, *OutputPackage, LOAD_None) : CreatePackage(*OutputPackage);
+
+		UAttackFrameDataTable* Table = FindObject<UAttackFrameDataTable>(Package, *AssetName);
+		if (Table == nullptr)
+		{
+			Table = NewObject<UAttackFrameDataTable>(Package, *AssetName, RF_Public | RF_Standalone);
+		}
+		Table->Entries = MoveTemp(Entries);
+		Package->MarkPackageDirty();
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		const FString Filename = FPackageName::LongPackageNameToFilename(OutputPackage, FPackageName::GetAssetPackageExtension());
+		if (!UPackage::SavePackage(Package, Table, *Filename, SaveArgs))
+		{
+			UE_LOG(LogAttackFrameData, Error, TEXT("Could not save %s"), *Filename);
+			return 1;
+		}
+	}
+
+	return NumErrors > 0 ? 1 : 0;
+#else
+	return 0;
+#endif
+}
+
+void UAttackFrameDataCommandlet::ExtractMontage(UAnimMontage* Montage, const FString& Owner, TArray<FAttackFrameEntry>& OutEntries)
+{
+	for (int32 SectionIndex = 0; SectionIndex < Montage->CompositeSections.Num(); ++SectionIndex)
+	{
+		FAttackFrameEntry& Entry = OutEntries.AddDefaulted_GetRef();
+		Entry.Montage = Montage;
+		Entry.SectionName = Montage->GetSectionName(SectionIndex);
+		Montage->GetSectionStartAndEndTime(SectionIndex, Entry.SectionStart, Entry.SectionEnd);
+
+		/**
+		* Notifies are sorted by time, so the first HitStart we find opens the window and the first HitEnd after it
+		*  closes it.
+		*/
+		for (const FAnimNotifyEvent& Event : Montage->Notifies)
+		{
+			const float Time = Event.GetTriggerTime();
+			if (Time < Entry.SectionStart || Time >= Entry.SectionEnd) continue;
+
+			const FName Name = GetNotifyName(Event);
+			if (Name == HitStartNotify)
+			{
+				if (Entry.HitActiveStart >= 0.f && Entry.HitActiveEnd < 0.f)
+				{
+					ReportError(Owner, Montage, Entry.SectionName, TEXT("weapon collision enabled twice without being disabled"));
+				}
+				if (Entry.HitActiveStart < 0.f) Entry.HitActiveStart = Time;
+			}
+			else if (Name == HitEndNotify)
+			{
+				if (Entry.HitActiveStart < 0.f)
+				{
+					ReportError(Owner, Montage, Entry.SectionName, TEXT("weapon collision disabled before being enabled"));
+				}
+				else if (Entry.HitActiveEnd < 0.f)
+				{
+					Entry.HitActiveEnd = Time;
+				}
+			}
+			else if ((Name == AttackEndNotify || Name == HitReactEndNotify) && Entry.ActionEnd < 0.f)
+			{
+				Entry.ActionEnd = Time;
+			}
+		}
+
+		if (Entry.HitActiveStart >= 0.f && Entry.HitActiveEnd < 0.f)
+		{
+			ReportError(Owner, Montage, Entry.SectionName, TEXT("weapon collision is never disabled"));
+		}
+		if (Entry.HasHitWindow() && Entry.HasActionEnd() && Entry.ActionEnd < Entry.HitActiveEnd)
+		{
+			ReportError(Owner, Montage, Entry.SectionName, TEXT("action ends while the weapon collision is still enabled"));
+		}
+
+		if (Entry.HasHitWindow())
+		{
+			const float RecoveryEnd = Entry.HasActionEnd() ? Entry.ActionEnd : Entry.SectionEnd;
+			Entry.Recovery = RecoveryEnd - Entry.HitActiveEnd;
+		}
+
+		UE_LOG(LogAttackFrameData, Display, TEXT("%s %s [%s]: %.3f-%.3f hit %.3f-%.3f end %.3f recovery %.3f"),
+			*Owner, *Montage->GetName(), *Entry.SectionName.ToString(), Entry.SectionStart, Entry.SectionEnd,
+			Entry.HitActiveStart, Entry.HitActiveEnd, Entry.ActionEnd, Entry.Recovery);
+	}
+}
+
+void UAttackFrameDataCommandlet::ReportError(const FString& Owner, const UAnimMontage* Montage, const FName& SectionName, const TCHAR* Problem)
+{
+	++NumErrors;
+	UE_LOG(LogAttackFrameData, Error, TEXT("%s %s [%s]: %s"), *Owner, *GetNameSafe(Montage), *SectionName.ToString(), Problem);
+}
@@ -0,0 +1,339 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/CombatSimCommandlet.h"
+#include "Performance/CombatHarness.h"
+
+/** Building and ticking the world */
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "UObject/UObjectArray.h"
+
+/** Report */
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatSim, Log, All);
+
+namespace
+{
+	/**
+	* Forwards everything to the allocator it wraps and counts the allocations, from every thread.
+	* Blocks allocated before it was installed are freed through it without trouble, since it doesn't touch them.
+	*/
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			AddAllocation(Count);
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			AddAllocation(Count);
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			// Only a block grown from nothing is a new allocation, resizing one isn't
+			if (Original == nullptr) AddAllocation(Count);
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Original == nullptr) AddAllocation(Count);
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+		FMalloc* GetInner() const { return Inner; }
+		uint64 GetNumAllocations() const { return NumAllocations.load(std::memory_order_relaxed); }
+		uint64 GetAllocatedBytes() const { return AllocatedBytes.load(std::memory_order_relaxed); }
+
+	private:
+		void AddAllocation(SIZE_T Size)
+		{
+			NumAllocations.fetch_add(1, std::memory_order_relaxed);
+			AllocatedBytes.fetch_add(Size, std::memory_order_relaxed);
+		}
+
+		FMalloc* Inner;
+		std::atomic<uint64> NumAllocations{0};
+		std::atomic<uint64> AllocatedBytes{0};
+	};
+
+	/** Counts the UObjects created and deleted (GC) while it's registered */
+	class FObjectChurnListener final : public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+	{
+	public:
+		virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override { ++NumCreated; }
+		virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override { ++NumDeleted; }
+		virtual void OnUObjectArrayShutdown() override
+		{
+			GUObjectArray.RemoveUObjectCreateListener(this);
+			GUObjectArray.RemoveUObjectDeleteListener(this);
+		}
+
+		int64 NumCreated = 0;
+		int64 NumDeleted = 0;
+	};
+}
+
+UCombatSimCommandlet::UCombatSimCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCombatSimCommandlet::Main(const FString& Params)
+{
+	FParse::Value(*Params, TEXT("Enemies="), NumEnemies);
+	FParse::Value(*Params, TEXT("Ticks="), NumTicks);
+	FParse::Value(*Params, TEXT("GCInterval="), GCInterval);
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = FPaths::ProfilingDir() / TEXT("SlashBenchmark") / FString::Printf(TEXT("CombatSim_%d.json"), NumEnemies);
+	}
+
+	/** A typo on the command line must not give a report that looks valid */
+	if (NumEnemies < 1 || NumTicks < 1 || TickRate <= 0.f || WarmupTicks < 0 || GCInterval < 0)
+	{
+		UE_LOG(LogCombatSim, Error, TEXT("Invalid settings: %d enemies and %d ticks (at least 1), tick rate %.2f (more than 0), %d warmup ticks and GC every %d ticks (0 or more)"),
+			NumEnemies, NumTicks, TickRate, WarmupTicks, GCInterval);
+		return 1;
+	}
+
+	/** Load everything first, so loading isn't measured as churn */
+	Harness = NewObject<UCombatHarness>(this);
+	if (!Harness->LoadClasses()) return 1;
+
+	/** Same random numbers on every run */
+	FMath::RandInit(0);
+	FMath::SRandInit(0);
+
+	UWorld* World = CreateSimWorld();
+	SpawnFloor(World);
+	Harness->SetOrigin(FVector(0.f, 0.f, 100.f));
+
+	for (int32 Tick = 0; Tick < WarmupTicks; ++Tick)
+	{
+		SpawnEnemies(World);
+		// No navmesh to walk on: the enemies are spawned within reach, so the stand-in only turns to the closest one
+		Harness->DriveStandIn(World, 0.f);
+		TickWorld(World);
+	}
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	/**
+	* Installed only for the measured ticks and never deleted: other threads may still be in it after GMalloc is
+	*  restored.
+	*/
+	FCountingMalloc* CountingMalloc = new FCountingMalloc(GMalloc);
+	FObjectChurnListener ChurnListener;
+	GUObjectArray.AddUObjectCreateListener(&ChurnListener);
+	GUObjectArray.AddUObjectDeleteListener(&ChurnListener);
+	GMalloc = CountingMalloc;
+
+	LiveObjectsAtStart = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	TickMs.Reserve(NumTicks);
+	AllocationsPerTick.Reserve(NumTicks);
+	AllocatedBytesPerTick.Reserve(NumTicks);
+	ObjectsCreatedPerTick.Reserve(NumTicks);
+
+	double TotalTickSeconds = 0.0;
+	for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+	{
+		const uint64 AllocationsBefore = CountingMalloc->GetNumAllocations();
+		const uint64 BytesBefore = CountingMalloc->GetAllocatedBytes();
+		const int64 CreatedBefore = ChurnListener.NumCreated;
+		const double StartTime = FPlatformTime::Seconds();
+
+		SpawnEnemies(World);
+		Harness->DriveStandIn(World, 0.f);
+		TickWorld(World);
+
+		const double TickSeconds = FPlatformTime::Seconds() - StartTime;
+		TotalTickSeconds += TickSeconds;
+		TickMs.Add(static_cast<float>(TickSeconds * 1000.0));
+		AllocationsPerTick.Add(static_cast<float>(CountingMalloc->GetNumAllocations() - AllocationsBefore));
+		AllocatedBytesPerTick.Add(static_cast<float>(CountingMalloc->GetAllocatedBytes() - BytesBefore));
+		ObjectsCreatedPerTick.Add(static_cast<float>(ChurnListener.NumCreated - CreatedBefore));
+
+		const FSlashPerfCounters& Counters = FSlashPerfCounters::Get();
+		for (int32 Bucket = 0; Bucket < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Bucket)
+		{
+			BucketTotalMs[Bucket] += Counters.GetBucketMsLastFrame(static_cast<ESlashPerfBucket>(Bucket));
+		}
+		TotalDamageEvents += Counters.GetDamageEventsLastFrame();
+
+		// Not part of the tick time: the engine loop spreads it over many frames
+		if (GCInterval > 0 && (Tick + 1) % GCInterval == 0)
+		{
+			const double GCStartTime = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			TotalGCMs += (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+			++NumGarbageCollections;
+		}
+	}
+
+	LiveObjectsAtEnd = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	GMalloc = CountingMalloc->GetInner();
+	GUObjectArray.RemoveUObjectCreateListener(&ChurnListener);
+	GUObjectArray.RemoveUObjectDeleteListener(&ChurnListener);
+	TotalObjectsCreated = ChurnListener.NumCreated;
+	TotalObjectsDeleted = ChurnListener.NumDeleted;
+
+	DestroySimWorld(World);
+
+	double TotalAllocations = 0.0;
+	for (const float Allocations : AllocationsPerTick)
+	{
+		TotalAllocations += Allocations;
+	}
+	UE_LOG(LogCombatSim, Display, TEXT("%d ticks with %d enemies: %.0f ticks/s, %.0f allocations/tick, %lld objects created, %lld deleted"),
+		NumTicks, NumEnemies, TotalTickSeconds > 0.0 ? NumTicks / TotalTickSeconds : 0.0,
+		NumTicks > 0 ? TotalAllocations / NumTicks : 0.0, TotalObjectsCreated, TotalObjectsDeleted);
+
+	if (!WriteReport(OutputPath, TotalTickSeconds))
+	{
+		UE_LOG(LogCombatSim, Error, TEXT("Could not write the combat simulation report to %s"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogCombatSim, Display, TEXT("Combat simulation report written to %s"), *OutputPath);
+	return 0;
+}
+
+UWorld* UCombatSimCommandlet::CreateSimWorld()
+{
+	/** No FX system nor audio, the rest (physics, AI, navigation system) is what the combat code needs */
+	const UWorld::InitializationValues InitValues = UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.CreateFXSystem(false)
+		.RequiresHitProxies(false)
+		.CreatePhysicsScene(true)
+		.CreateAISystem(true)
+		.CreateNavigation(true)
+		.ShouldSimulatePhysics(true);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CombatSim"), nullptr, true, ERHIFeatureLevel::Num, &InitValues);
+	GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+
+	/** Actors only get BeginPlay through a game mode; the plain one, no player is ever logged in */
+	World->GetWorldSettings()->DefaultGameMode = AGameModeBase::StaticClass();
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+	return World;
+}
+
+void UCombatSimCommandlet::DestroySimWorld(UWorld* World)
+{
+	Harness->Reset();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void UCombatSimCommandlet::SpawnFloor(UWorld* World)
+{
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(FVector(0.f, 0.f, -50.f), FRotator::ZeroRotator);
+	if (Floor == nullptr || Cube == nullptr) return;
+
+	Floor->GetStaticMeshComponent()->SetStaticMesh(Cube);
+	Floor->SetActorScale3D(FVector(200.f, 200.f, 1.f));
+}
+
+void UCombatSimCommandlet::SpawnEnemies(UWorld* World)
+{
+	/** Rings of 8 enemies around the stand-in, facing it */
+	Harness->SpawnEnemies(World, NumEnemies, SpawnRadius, 8, 100.f);
+}
+
+void UCombatSimCommandlet::TickWorld(UWorld* World)
+{
+	/** What the engine loop does around UWorld::Tick, minus everything about rendering, audio and input */
+	const double DeltaTime = 1.0 / TickRate;
+	FApp::SetDeltaTime(DeltaTime);
+	FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaTime);
+
+	FCoreDelegates::OnBeginFrame.Broadcast();
+	World->Tick(LEVELTICK_All, static_cast<float>(DeltaTime));
+	FCoreDelegates::OnEndFrame.Broadcast();
+	++GFrameCounter;
+}
+
+bool UCombatSimCommandlet::WriteReport(const FString& Path, double TotalTickSeconds) const
+{
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("BuildVersion"), FApp::GetBuildVersion());
+	Report->SetNumberField(TEXT("NumEnemies"), NumEnemies);
+	Report->SetNumberField(TEXT("Ticks"), NumTicks);
+	Report->SetNumberField(TEXT("TickRate"), TickRate);
+	Report->SetNumberField(TEXT("TicksPerSecond"), TotalTickSeconds > 0.0 ? NumTicks / TotalTickSeconds : 0.0);
+	Report->SetNumberField(TEXT("EnemiesSpawned"), Harness->GetNumEnemiesSpawned());
+	Report->SetNumberField(TEXT("StandInDeaths"), Harness->GetNumStandInDeaths());
+	Report->SetNumberField(TEXT("DamageEvents"), static_cast<double>(TotalDamageEvents));
+
+	Report->SetObjectField(TEXT("TickMs"), UCombatHarness::MakeDistribution(TickMs));
+	Report->SetObjectField(TEXT("AllocationsPerTick"), UCombatHarness::MakeDistribution(AllocationsPerTick));
+	Report->SetObjectField(TEXT("AllocatedBytesPerTick"), UCombatHarness::MakeDistribution(AllocatedBytesPerTick));
+
+	/** Created during the measured ticks, deleted by the garbage collections in between */
+	TSharedRef<FJsonObject> Objects = MakeShared<FJsonObject>();
+	Objects->SetNumberField(TEXT("Created"), static_cast<double>(TotalObjectsCreated));
+	Objects->SetNumberField(TEXT("Deleted"), static_cast<double>(TotalObjectsDeleted));
+	Objects->SetObjectField(TEXT("CreatedPerTick"), UCombatHarness::MakeDistribution(ObjectsCreatedPerTick));
+	Objects->SetNumberField(TEXT("LiveAtStart"), LiveObjectsAtStart);
+	Objects->SetNumberField(TEXT("LiveAtEnd"), LiveObjectsAtEnd);
+	Objects->SetNumberField(TEXT("GarbageCollections"), NumGarbageCollections);
+	Objects->SetNumberField(TEXT("GarbageCollectionMs"), TotalGCMs);
+	Report->SetObjectField(TEXT("UObjects"), Objects);
+
+	/** Same buckets as the perf overlay and the combat benchmark */
+	TSharedRef<FJsonObject> Buckets = MakeShared<FJsonObject>();
+	for (int32 Bucket = 0; Bucket < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Bucket)
+	{
+		Buckets->SetNumberField(FSlashPerfCounters::GetBucketName(static_cast<ESlashPerfBucket>(Bucket)), NumTicks > 0 ? BucketTotalMs[Bucket] / NumTicks : 0.0);
+	}
+	Report->SetObjectField(TEXT("SubsystemsAverageMs"), Buckets);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if (!FJsonSerializer::Serialize(Report, Writer)) return false;
+
+	return FFileHelper::SaveStringToFile(Json, *Path);
+}
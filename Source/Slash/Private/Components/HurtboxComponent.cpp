@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/HurtboxComponent.h"
+#include "Combat/HurtboxProfile.h"
+
+/** Read the bone transforms of our owner's mesh */
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+
+UHurtboxComponent::UHurtboxComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+bool UHurtboxComponent::HasCapsules() const
+{
+	return Profile && Profile->Capsules.Num() > 0;
+}
+
+void UHurtboxComponent::UpdateCapsules()
+{
+	if (LastUpdateFrame == GFrameCounter) return;
+	LastUpdateFrame = GFrameCounter;
+
+	if (OwnerMesh == nullptr)
+	{
+		ACharacter* Character = Cast<ACharacter>(GetOwner());
+		OwnerMesh = Character ? Character->GetMesh() : GetOwner()->FindComponentByClass<USkeletalMeshComponent>();
+	}
+
+	WorldCapsules.Reset(Profile->Capsules.Num());
+	if (OwnerMesh == nullptr) return;
+
+	for (const FHurtboxCapsule& Capsule : Profile->Capsules)
+	{
+		/** 
+		* Place the capsule relative to its bone, then take its local Z axis to build the segment.
+		* The segment is shorter than the capsule by the radius on each side (the hemispheres cover the rest).
+		*/
+		const FTransform BoneTransform = OwnerMesh->GetSocketTransform(Capsule.BoneName);
+		const FTransform CapsuleTransform = FTransform(Capsule.Rotation, Capsule.Offset) * BoneTransform;
+
+		const FVector Center = CapsuleTransform.GetLocation();
+		const FVector Axis = CapsuleTransform.GetUnitAxis(EAxis::Z);
+		const float SegmentHalfLength = FMath::Max(Capsule.HalfHeight - Capsule.Radius, 0.f);
+
+		WorldCapsules.Add({ Center - Axis * SegmentHalfLength, Center + Axis * SegmentHalfLength, Capsule.Radius });
+	}
+}
+
+bool UHurtboxComponent::SweepSegment(const FVector& Start, const FVector& End, float SweepRadius, FHurtboxHit& OutHit)
+{
+	if (!HasCapsules()) return false;
+
+	UpdateCapsules();
+
+	int32 BestIndex = INDEX_NONE;
+	double BestDistanceFromStart = TNumericLimits<double>::Max();
+
+	for (int32 Index = 0; Index < WorldCapsules.Num(); ++Index)
+	{
+		const FWorldCapsule& Capsule = WorldCapsules[Index];
+
+		// Closest points between the weapon segment (OnBlade) and the capsule segment (OnCapsule)
+		FVector OnBlade;
+		FVector OnCapsule;
+		FMath::SegmentDistToSegmentSafe(Start, End, Capsule.A, Capsule.B, OnBlade, OnCapsule);
+
+		const double HitRadius = Capsule.Radius + SweepRadius;
+		if (FVector::DistSquared(OnBlade, OnCapsule) > HitRadius * HitRadius) continue;
+
+		const double DistanceFromStart = FVector::DistSquared(Start, OnBlade);
+		if (DistanceFromStart < BestDistanceFromStart)
+		{
+			BestDistanceFromStart = DistanceFromStart;
+			BestIndex = Index;
+
+			// Impact on the capsule surface, facing the blade
+			const FVector Normal = (OnBlade - OnCapsule).GetSafeNormal();
+			OutHit.ImpactNormal = Normal.IsNearlyZero() ? (Start - OnCapsule).GetSafeNormal() : Normal;
+			OutHit.ImpactPoint = OnCapsule + OutHit.ImpactNormal * Capsule.Radius;
+		}
+	}
+
+	if (BestIndex == INDEX_NONE) return false;
+
+	const FHurtboxCapsule& HitCapsule = Profile->Capsules[BestIndex];
+	OutHit.Region = HitCapsule.Region;
+	OutHit.DamageMultiplier = HitCapsule.DamageMultiplier;
+	return true;
+}
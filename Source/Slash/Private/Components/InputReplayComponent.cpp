@@ -0,0 +1,324 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/InputReplayComponent.h"
+#include "Characters/SlashCharacter.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogInputReplay, Log, All);
+
+namespace
+{
+	constexpr uint32 RecordingMagic = 0x52494C53; // "SLIR"
+	constexpr int32 RecordingVersion = 1;
+	// Time, action and value type, with one axis
+	constexpr int64 MinBytesPerAction = sizeof(float) + 2 * sizeof(uint8) + sizeof(float);
+
+	/** Only the axes the value type uses are stored */
+	int32 GetNumAxes(EInputActionValueType ValueType)
+	{
+		switch (ValueType)
+		{
+		case EInputActionValueType::Axis2D: return 2;
+		case EInputActionValueType::Axis3D: return 3;
+		default: return 1;
+		}
+	}
+
+	UInputReplayComponent* FindInputReplay(UWorld* World)
+	{
+		const APawn* Pawn = World ? UGameplayStatics::GetPlayerPawn(World, 0) : nullptr;
+		return Pawn ? Pawn->FindComponentByClass<UInputReplayComponent>() : nullptr;
+	}
+
+	void RecordInput(const TArray<FString>& Args, UWorld* World)
+	{
+		if (UInputReplayComponent* InputReplay = FindInputReplay(World))
+		{
+			InputReplay->StartRecording(Args.Num() > 0 ? Args[0] : TEXT("Session"));
+		}
+	}
+
+	void ReplayInput(const TArray<FString>& Args, UWorld* World)
+	{
+		if (UInputReplayComponent* InputReplay = FindInputReplay(World))
+		{
+			InputReplay->StartPlayback(Args.Num() > 0 ? Args[0] : TEXT("Session"));
+		}
+	}
+
+	void StopInput(UWorld* World)
+	{
+		if (UInputReplayComponent* InputReplay = FindInputReplay(World))
+		{
+			InputReplay->Stop();
+		}
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs RecordInputCommand(
+		TEXT("Slash.Input.Record"),
+		TEXT("Record Echo's input actions to Saved/InputRecordings/<Name>.slashinput until Slash.Input.Stop"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RecordInput)
+	);
+
+	FAutoConsoleCommandWithWorldAndArgs ReplayInputCommand(
+		TEXT("Slash.Input.Replay"),
+		TEXT("Play back Saved/InputRecordings/<Name>.slashinput at a fixed timestep"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ReplayInput)
+	);
+
+	FAutoConsoleCommandWithWorld StopInputCommand(
+		TEXT("Slash.Input.Stop"),
+		TEXT("Stop recording (and save) or playing back Echo's input actions"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&StopInput)
+	);
+}
+
+UInputReplayComponent::UInputReplayComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+FString UInputReplayComponent::GetRecordingPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("InputRecordings") / Name + TEXT(".slashinput");
+}
+
+void UInputReplayComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SlashCharacter = Cast<ASlashCharacter>(GetOwner());
+	if (SlashCharacter == nullptr) return;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("SlashReplayInput="), PendingName))
+	{
+		bPendingPlayback = true;
+		bExitAfterPlayback = FParse::Param(FCommandLine::Get(), TEXT("ReplayExit"));
+	}
+	else
+	{
+		FParse::Value(FCommandLine::Get(), TEXT("SlashRecordInput="), PendingName);
+	}
+
+	if (!PendingName.IsEmpty())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UInputReplayComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Stop();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UInputReplayComponent::StartRecording(const FString& Name)
+{
+	Stop();
+
+	/** Same seed on playback, so random choices (attack sections, patrol waits...) are the same */
+	RandomSeed = static_cast<int32>(FPlatformTime::Cycles());
+	FMath::RandInit(RandomSeed);
+	FMath::SRandInit(RandomSeed);
+
+	/**
+	* Recorded at the playback's fixed timestep: Move and Look fire once per frame, so a recording made at another
+	*  frame rate would move Echo at another speed when played back.
+	*/
+	UseFixedTimeStep();
+
+	Actions.Reset();
+	RecordingPath = GetRecordingPath(Name);
+	StartTime = GetWorld()->GetTimeSeconds();
+	bRecording = true;
+	UE_LOG(LogInputReplay, Display, TEXT("Recording input to %s"), *RecordingPath);
+}
+
+void UInputReplayComponent::StartPlayback(const FString& Name)
+{
+	Stop();
+
+	if (SlashCharacter == nullptr || !Load(GetRecordingPath(Name)))
+	{
+		UE_LOG(LogInputReplay, Error, TEXT("Could not play back %s"), *GetRecordingPath(Name));
+		return;
+	}
+
+	FMath::RandInit(RandomSeed);
+	FMath::SRandInit(RandomSeed);
+	UseFixedTimeStep();
+
+	NextAction = 0;
+	StartTime = GetWorld()->GetTimeSeconds();
+	bPlaying = true;
+	SetComponentTickEnabled(true);
+	UE_LOG(LogInputReplay, Display, TEXT("Playing back %d input actions from %s at %.0f fps"), Actions.Num(), *RecordingPath, FixedFrameRate);
+}
+
+void UInputReplayComponent::Stop()
+{
+	if (bRecording)
+	{
+		bRecording = false;
+		RestoreTimeStep();
+		if (Save())
+		{
+			UE_LOG(LogInputReplay, Display, TEXT("Saved %d input actions to %s"), Actions.Num(), *RecordingPath);
+		}
+		else
+		{
+			UE_LOG(LogInputReplay, Error, TEXT("Could not save %s"), *RecordingPath);
+		}
+	}
+
+	if (bPlaying)
+	{
+		bPlaying = false;
+		RestoreTimeStep();
+		SetComponentTickEnabled(false);
+	}
+}
+
+void UInputReplayComponent::UseFixedTimeStep()
+{
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FixedFrameRate);
+}
+
+void UInputReplayComponent::RestoreTimeStep()
+{
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+}
+
+void UInputReplayComponent::RecordAction(ESlashInputAction Action, const FInputActionValue& Value)
+{
+	if (!bRecording) return;
+
+	FRecordedAction& Recorded = Actions.AddDefaulted_GetRef();
+	Recorded.Time = static_cast<float>(GetWorld()->GetTimeSeconds() - StartTime);
+	Recorded.Action = Action;
+	Recorded.ValueType = Value.GetValueType();
+	Recorded.Value = FVector3f(Value.Get<FVector>());
+}
+
+void UInputReplayComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Only the player's Echo, not every Echo in the world (e.g. the benchmark stand-in)
+	if (!PendingName.IsEmpty() && SlashCharacter->IsPlayerControlled())
+	{
+		if (bPendingPlayback)
+		{
+			StartPlayback(PendingName);
+		}
+		else
+		{
+			StartRecording(PendingName);
+		}
+		PendingName.Reset();
+	}
+
+	if (!bPlaying)
+	{
+		SetComponentTickEnabled(!PendingName.IsEmpty());
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds() - StartTime;
+	while (NextAction < Actions.Num() && Actions[NextAction].Time <= Now)
+	{
+		const FRecordedAction& Recorded = Actions[NextAction++];
+		SlashCharacter->DispatchInputAction(Recorded.Action, FInputActionValue(Recorded.ValueType, FVector(Recorded.Value)));
+	}
+
+	if (NextAction >= Actions.Num())
+	{
+		UE_LOG(LogInputReplay, Display, TEXT("Playback of %s finished after %.1f seconds"), *RecordingPath, Now);
+		Stop();
+
+		if (bExitAfterPlayback)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+bool UInputReplayComponent::Save()
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	SerializeRecording(Writer);
+	return FFileHelper::SaveArrayToFile(Bytes, *RecordingPath);
+}
+
+bool UInputReplayComponent::Load(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path)) return false;
+
+	FMemoryReader Reader(Bytes);
+	SerializeRecording(Reader);
+	RecordingPath = Path;
+	return !Reader.IsError();
+}
+
+void UInputReplayComponent::SerializeRecording(FArchive& Ar)
+{
+	uint32 Magic = RecordingMagic;
+	int32 Version = RecordingVersion;
+	Ar << Magic << Version;
+	if (Ar.IsLoading() && (Magic != RecordingMagic || Version != RecordingVersion))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << RandomSeed;
+
+	int32 NumActions = Actions.Num();
+	Ar << NumActions;
+	if (Ar.IsLoading())
+	{
+		/** A corrupt count must not allocate more actions than the rest of the file can hold */
+		if (NumActions < 0 || NumActions > (Ar.TotalSize() - Ar.Tell()) / MinBytesPerAction)
+		{
+			Ar.SetError();
+			return;
+		}
+		Actions.SetNum(NumActions);
+	}
+
+	/** Time, action, value type, then only the axes used: 7 bytes for a button, 14 for a stick */
+	for (FRecordedAction& Recorded : Actions)
+	{
+		uint8 Action = static_cast<uint8>(Recorded.Action);
+		uint8 ValueType = static_cast<uint8>(Recorded.ValueType);
+		Ar << Recorded.Time << Action << ValueType;
+		Recorded.Action = static_cast<ESlashInputAction>(Action);
+		Recorded.ValueType = static_cast<EInputActionValueType>(ValueType);
+
+		for (int32 Axis = 0; Axis < GetNumAxes(Recorded.ValueType); ++Axis)
+		{
+			Ar << Recorded.Value[Axis];
+		}
+
+		if (Ar.IsLoading() && Recorded.Action >= ESlashInputAction::ESIA_MAX)
+		{
+			Ar.SetError();
+			return;
+		}
+	}
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/MontagePlayerComponent.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+
+UMontagePlayerComponent::UMontagePlayerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UMontagePlayerComponent::RegisterMontage(EMontageType Type, UAnimMontage* Montage)
+{
+	FRegisteredMontage& Registered = Montages[static_cast<uint8>(Type)];
+	if (Registered.Montage == Montage) return;
+
+	Registered.Montage = Montage;
+	Registered.Sections.Reset();
+	Registered.LastSection = NAME_None;
+	Registered.LastFrame = 0;
+	if (Montage)
+	{
+		ReferencedMontages.AddUnique(Montage);
+	}
+}
+
+bool UMontagePlayerComponent::Play(EMontageType Type, const FName& SectionName, bool bSkipIfPlaying)
+{
+	FRegisteredMontage& Registered = Montages[static_cast<uint8>(Type)];
+	UAnimInstance* AnimInstance = GetAnimInstance();
+	if (AnimInstance == nullptr || Registered.Montage == nullptr) return false;
+
+	/** Nothing would change */
+	if (Registered.LastFrame == GFrameCounter && Registered.LastSection == SectionName) return false;
+	if (bSkipIfPlaying && AnimInstance->Montage_IsPlaying(Registered.Montage)) return false;
+
+	const FCachedSection* Section = FindSection(Registered, SectionName);
+	if (Section == nullptr) return false;
+
+	// Starting at the section's time is the same as jumping to it, without looking up its name again
+	AnimInstance->Montage_Play(Registered.Montage, 1.f, EMontagePlayReturnType::MontageLength, Section->StartTime);
+
+	Registered.LastSection = SectionName;
+	Registered.LastFrame = GFrameCounter;
+	return true;
+}
+
+void UMontagePlayerComponent::Stop(EMontageType Type, float BlendOutTime)
+{
+	FRegisteredMontage& Registered = Montages[static_cast<uint8>(Type)];
+	UAnimInstance* AnimInstance = GetAnimInstance();
+	if (AnimInstance && Registered.Montage)
+	{
+		AnimInstance->Montage_Stop(BlendOutTime, Registered.Montage);
+	}
+	Registered.LastSection = NAME_None;
+}
+
+bool UMontagePlayerComponent::IsPlaying(EMontageType Type) const
+{
+	const UAnimMontage* Montage = GetMontage(Type);
+	const UAnimInstance* AnimInstance = GetAnimInstance();
+	return AnimInstance && Montage && AnimInstance->Montage_IsPlaying(Montage);
+}
+
+const UMontagePlayerComponent::FCachedSection* UMontagePlayerComponent::FindSection(FRegisteredMontage& Registered, const FName& SectionName) const
+{
+	if (const FCachedSection* Cached = Registered.Sections.Find(SectionName))
+	{
+		return Cached->Index != INDEX_NONE ? Cached : nullptr;
+	}
+
+	/** First time we see this section: resolve it once (missing sections are cached too, so we don't look again) */
+	FCachedSection& Section = Registered.Sections.Add(SectionName);
+	Section.Index = Registered.Montage->GetSectionIndex(SectionName);
+	if (Section.Index == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s has no section %s"), *Registered.Montage->GetName(), *SectionName.ToString());
+		return nullptr;
+	}
+
+	float EndTime = 0.f;
+	Registered.Montage->GetSectionStartAndEndTime(Section.Index, Section.StartTime, EndTime);
+	return &Section;
+}
+
+UAnimInstance* UMontagePlayerComponent::GetAnimInstance() const
+{
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+	return Character && Character->GetMesh() ? Character->GetMesh()->GetAnimInstance() : nullptr;
+}
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/SoulMagnetComponent.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Characters/SlashCharacter.h"
+#include "Items/Soul.h"
+#include "Items/PickupSubsystem.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Soul Magnet Tick"), STAT_SlashSoulMagnetTick, STATGROUP_Slash);
+
+USoulMagnetComponent::USoulMagnetComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	// Move the souls after the character moved, so they home to where it is this frame
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void USoulMagnetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	HomingSouls.Empty();
+	Positions.Empty();
+	Velocities.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USoulMagnetComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	SLASH_SCOPE(SPB_Pickups, SoulMagnetTick);
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (Character == nullptr)
+	{
+		Character = Cast<ASlashCharacter>(GetOwner());
+		if (Character == nullptr) return;
+	}
+
+	const FVector TargetLocation = Character->GetActorLocation();
+
+	TimeSinceAcquire += DeltaTime;
+	if (bMagnetEnabled && TimeSinceAcquire >= AcquireInterval)
+	{
+		TimeSinceAcquire = 0.f;
+		AcquireSouls(TargetLocation);
+	}
+
+	if (HomingSouls.Num() == 0) return;
+
+	IntegrateHoming(TargetLocation, DeltaTime);
+
+	/** Collect everything that arrived this frame at once */
+	int32 CollectedSouls = 0;
+	for (int32 Index : Arrived)
+	{
+		ASoul* Soul = HomingSouls[Index];
+		if (IsValid(Soul))
+		{
+			CollectedSouls += Soul->CollectByMagnet();
+		}
+	}
+	// Arrived is sorted, so removing from the back keeps the other indices valid
+	for (int32 ArrivedIndex = Arrived.Num() - 1; ArrivedIndex >= 0; --ArrivedIndex)
+	{
+		RemoveHomingAt(Arrived[ArrivedIndex]);
+	}
+
+	if (CollectedSouls > 0)
+	{
+		Character->CollectSouls(CollectedSouls);
+	}
+}
+
+void USoulMagnetComponent::AcquireSouls(const FVector& TargetLocation)
+{
+	TArray<AItem*> InRange;
+	UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>();
+	if (Pickups && UPickupSubsystem::IsIndexEnabled())
+	{
+		Pickups->QueryPickups(TargetLocation, TargetLocation, MagnetRadius, InRange);
+	}
+	else
+	{
+		/** Without the index the souls are only in the physics scene, through their overlap spheres */
+		TArray<FOverlapResult> Overlaps;
+		GetWorld()->OverlapMultiByObjectType(Overlaps, TargetLocation, FQuat::Identity, FCollisionObjectQueryParams(ECC_WorldDynamic), FCollisionShape::MakeSphere(MagnetRadius));
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			if (ASoul* Soul = Cast<ASoul>(Overlap.GetActor()))
+			{
+				InRange.AddUnique(Soul);
+			}
+		}
+	}
+
+	for (AItem* Item : InRange)
+	{
+		ASoul* Soul = Cast<ASoul>(Item);
+		// Its mesh may still be found by the overlap query once homing
+		if (Soul == nullptr || HomingSouls.Contains(Soul)) continue;
+
+		// Leaves the pickup index, so we won't find it again
+		Soul->StartHoming();
+		HomingSouls.Add(Soul);
+		Positions.Add(Soul->GetActorLocation());
+		Velocities.Add(FVector::ZeroVector);
+	}
+}
+
+void USoulMagnetComponent::IntegrateHoming(const FVector& TargetLocation, float DeltaTime)
+{
+	Arrived.Reset();
+
+	const int32 NumSouls = HomingSouls.Num();
+	FVector* RESTRICT Position = Positions.GetData();
+	FVector* RESTRICT Velocity = Velocities.GetData();
+	const double MaxSpeedSquared = FMath::Square(MaxSpeed);
+	const double CollectRadiusSquared = FMath::Square(CollectRadius);
+
+	/** Only math on the arrays here, the actors are moved in a second loop */
+	for (int32 Index = 0; Index < NumSouls; ++Index)
+	{
+		const FVector ToTarget = TargetLocation - Position[Index];
+		const double DistanceSquared = ToTarget.SizeSquared();
+		if (DistanceSquared <= CollectRadiusSquared)
+		{
+			Arrived.Add(Index);
+			continue;
+		}
+
+		Velocity[Index] += ToTarget * (FMath::InvSqrt(DistanceSquared) * Acceleration * DeltaTime);
+		const double SpeedSquared = Velocity[Index].SizeSquared();
+		if (SpeedSquared > MaxSpeedSquared)
+		{
+			Velocity[Index] *= MaxSpeed * FMath::InvSqrt(SpeedSquared);
+		}
+		Position[Index] += Velocity[Index] * DeltaTime;
+	}
+
+	for (int32 Index = 0; Index < NumSouls; ++Index)
+	{
+		ASoul* Soul = HomingSouls[Index];
+		if (IsValid(Soul))
+		{
+			Soul->SetActorLocation(Position[Index]);
+		}
+	}
+}
+
+void USoulMagnetComponent::RemoveHomingAt(int32 Index)
+{
+	HomingSouls.RemoveAtSwap(Index);
+	Positions.RemoveAtSwap(Index);
+	Velocities.RemoveAtSwap(Index);
+}
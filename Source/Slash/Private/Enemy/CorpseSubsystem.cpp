@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/CorpseSubsystem.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Enemy/Enemy.h"
+
+DECLARE_CYCLE_STAT(TEXT("Corpse Subsystem Tick"), STAT_SlashCorpseTick, STATGROUP_Slash);
+
+void UCorpseSubsystem::RegisterRagdoll(AEnemy* Enemy)
+{
+	if (Enemy == nullptr) return;
+
+	FRagdollEntry& Entry = Ragdolls.AddDefaulted_GetRef();
+	Entry.Enemy = Enemy;
+	Entry.StartTime = GetWorld()->GetTimeSeconds();
+
+	// The new one is the last, the oldest are frozen to make room for it
+	while (Ragdolls.Num() > FMath::Max(MaxRagdolls, 0))
+	{
+		FreezeRagdollAt(0);
+	}
+}
+
+void UCorpseSubsystem::Tick(float DeltaTime)
+{
+	SLASH_SCOPE(SPB_Animation, CorpseTick);
+	Super::Tick(DeltaTime);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	while (Ragdolls.Num() > 0 && (!Ragdolls[0].Enemy.IsValid() || Now - Ragdolls[0].StartTime >= RagdollSleepAfter))
+	{
+		FreezeRagdollAt(0);
+	}
+}
+
+void UCorpseSubsystem::FreezeRagdollAt(int32 Index)
+{
+	if (AEnemy* Enemy = Ragdolls[Index].Enemy.Get())
+	{
+		Enemy->FreezeRagdoll();
+	}
+
+	// Keep the order, the oldest must stay first
+	Ragdolls.RemoveAt(Index);
+}
+
+TStatId UCorpseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCorpseSubsystem, STATGROUP_Tickables);
+}
+
+bool UCorpseSubsystem::IsTickable() const
+{
+	return Ragdolls.Num() > 0;
+}
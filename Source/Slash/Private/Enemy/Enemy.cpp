@@ -2,6 +2,9 @@
 
 
 #include "Enemy/Enemy.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashTrace.h"
+#include "Performance/SlashMemory.h"
 
 /** Skeletal mesh component (AEnemy()) */
 #include "Components/SkeletalMeshComponent.h"
@@ -25,7 +28,133 @@
 
 #include "NiagaraComponent.h"
 
-#include "HUD/LockedTargetComponent.h"
+#include "HUD/SlashHUD.h"
+#include "Kismet/GameplayStatics.h"
+#include "Components/MontagePlayerComponent.h"
+
+/** Animation budget */
+#include "SkeletalMeshComponentBudgeted.h"
+#include "IAnimationBudgetAllocator.h"
+#include "Misc/App.h"
+
+/** Corpse */
+#include "Enemy/CorpseSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Tick"), STAT_SlashEnemyTick, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Enemy CheckCombatTarget"), STAT_SlashEnemyCheckCombatTarget, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Enemy PawnSeen"), STAT_SlashEnemyPawnSeen, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Enemy TakeDamage"), STAT_SlashEnemyTakeDamage, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Enemy MoveToTarget"), STAT_SlashEnemyMoveToTarget, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Enemy Animation Significance"), STAT_SlashEnemyAnimationSignificance, STATGROUP_Slash);
+
+void AEnemy::UpdateAnimationSignificance()
+{
+	SLASH_SCOPE(SPB_Animation, EnemyAnimationSignificance);
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if (BudgetedMesh == nullptr || Allocator == nullptr) return;
+
+	/** 
+	* Distance to the closest player pawn rather than to a camera: there are no cameras on a dedicated server, 
+	*  but the enemies near a player still need their animation (root motion, notifies, bone positions for hits).
+	*/
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* PlayerPawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+		if (PlayerPawn)
+		{
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(PlayerPawn->GetActorLocation(), GetActorLocation()));
+		}
+	}
+
+	const bool bInCombat = EnemyState > EEnemyState::EES_Patrolling;
+	// Nothing is ever rendered on a server, with -nullrhi (benchmark) or in a commandlet: notifies must still fire
+	const bool bHeadless = IsRunningDedicatedServer() || !FApp::CanEverRender();
+	const float Distance = ClosestDistanceSquared < TNumericLimits<double>::Max() ? FMath::Sqrt(ClosestDistanceSquared) : SignificanceDistance * 10.f;
+	float Significance = SignificanceDistance / (SignificanceDistance + Distance);
+	if (bInCombat)
+	{
+		Significance *= CombatSignificanceScale;
+	}
+
+	Allocator->SetComponentSignificance(
+		BudgetedMesh,
+		Significance,
+		/*bNeverSkip*/ bInCombat,
+		/*bTickEvenIfNotRendered*/ bInCombat || bHeadless,
+		/*bAllowReducedWork*/ !bInCombat
+	);
+}
+
+void AEnemy::SettleCorpse(float DeltaTime)
+{
+	if (MontagePlayer->IsPlaying(EMontageType::EMT_Death)) return;
+
+	TimeSinceDeathMontage += DeltaTime;
+	if (TimeSinceDeathMontage < CorpseSettleTime) return;
+
+	if (bRagdollCorpse)
+	{
+		StartRagdoll();
+	}
+	else
+	{
+		FreezeCorpse();
+	}
+}
+
+void AEnemy::StopCorpseWork()
+{
+	SetActorTickEnabled(false);
+
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	if (PawnSensing) PawnSensing->SetSensingUpdatesEnabled(false);
+
+	// Otherwise the allocator keeps turning the mesh tick back on
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if (BudgetedMesh && Allocator)
+	{
+		Allocator->UnregisterComponent(BudgetedMesh);
+	}
+}
+
+void AEnemy::FreezeCorpse()
+{
+	StopCorpseWork();
+
+	/** The last evaluated pose stays: no more animation update, bone update nor mesh tick */
+	GetMesh()->bPauseAnims = true;
+	GetMesh()->bNoSkeletonUpdate = true;
+	GetMesh()->SetComponentTickEnabled(false);
+}
+
+void AEnemy::StartRagdoll()
+{
+	StopCorpseWork();
+
+	// The mesh keeps ticking to follow the bodies, but there's no animation to evaluate anymore
+	GetMesh()->bPauseAnims = true;
+	GetMesh()->SetCollisionProfileName(TEXT("Ragdoll"));
+	GetMesh()->SetAllBodiesSimulatePhysics(true);
+	GetMesh()->WakeAllRigidBodies();
+
+	if (UCorpseSubsystem* Corpses = GetWorld()->GetSubsystem<UCorpseSubsystem>())
+	{
+		Corpses->RegisterRagdoll(this);
+	}
+}
+
+void AEnemy::FreezeRagdoll()
+{
+	GetMesh()->PutAllRigidBodiesToSleep();
+	GetMesh()->bNoSkeletonUpdate = true;
+	GetMesh()->SetAllBodiesSimulatePhysics(false);
+	GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GetMesh()->SetComponentTickEnabled(false);
+}
 
 void AEnemy::InitializeEnemy()
 {
@@ -84,7 +213,7 @@ void AEnemy::CheckPatrolTarget() // EEnemyState::EES_Patrolling
 		// Also check if it's not in IdlePatrol state already? This prevents bugs for spamming setting the same state
 		if (EnemyState == EEnemyState::EES_Patrolling) 
 		{
-			EnemyState = EEnemyState::EES_IdlePatrol;
+			SetEnemyState(EEnemyState::EES_IdlePatrol);
 		}
 
 		const float WaitTime = FMath::RandRange(PatrolWaitMin, PatrolWaitMax);
@@ -101,13 +230,14 @@ void AEnemy::PatrolTimerFinished()
 void AEnemy::StartPatrolling()
 {
 	/** Return to Patrolling: state and velocity, and move to target (PatrolTarget) */
-	EnemyState = EEnemyState::EES_Patrolling;
+	SetEnemyState(EEnemyState::EES_Patrolling);
 	GetCharacterMovement()->MaxWalkSpeed = PatrollingSpeed;
 	MoveToTarget(PatrolTarget);
 }
 
 void AEnemy::MoveToTarget(AActor* Target)
 {
+	SLASH_SCOPE(SPB_AI, EnemyMoveToTarget);
 	if (EnemyController == nullptr || Target == nullptr) return;
 
 	FAIMoveRequest MoveRequest;
@@ -116,11 +246,18 @@ void AEnemy::MoveToTarget(AActor* Target)
 	EnemyController->MoveTo(MoveRequest);
 }
 
+bool AEnemy::IsWaitingForPath() const
+{
+	return EnemyController && EnemyController->GetMoveStatus() == EPathFollowingStatus::Waiting;
+}
+
 void AEnemy::SpawnDefaultWeapon()
 {
+	LLM_SCOPE_BYTAG(Slash_Weapons);
 	UWorld* World = GetWorld();
 	if (World && WeaponClass)
 	{
+		INC_DWORD_STAT(STAT_SlashSpawns);
 		AWeapon* DefaultWeapon = World->SpawnActor<AWeapon>(WeaponClass);
 		DefaultWeapon->Equip(GetMesh(), FName("WeaponSocket"), this, this);
 		EquippedWeapon = DefaultWeapon;
@@ -134,6 +271,7 @@ void AEnemy::ClearPatrolTimer()
 
 void AEnemy::CheckCombatTarget()
 {
+	SLASH_SCOPE(SPB_AI, EnemyCheckCombatTarget);
 	/** 
 	* IMPORTANT:
 	* Although ClearAttackTimer() is called in every if statement below, it shouldn't be placed outside them.
@@ -186,7 +324,7 @@ void AEnemy::CheckCombatTarget()
 
 void AEnemy::ChaseTarget() 
 {
-	EnemyState = EEnemyState::EES_Chasing;
+	SetEnemyState(EEnemyState::EES_Chasing);
 	GetCharacterMovement()->MaxWalkSpeed = ChasingSpeed;
 	MoveToTarget(CombatTarget);
 }
@@ -215,6 +353,7 @@ void AEnemy::HideHealthBar()
 
 void AEnemy::PawnSeen(APawn* SeenPawn)
 {
+	SLASH_SCOPE(SPB_AI, EnemyPawnSeen);
 	/**
 	* Create a local bool in order to refactor a code where we can join if statements,
 	*  like in this case where we don't want to continue unless SeenPawn->ActorHasTag(FName("SlashCharacter")) 
@@ -240,11 +379,7 @@ void AEnemy::PawnSeen(APawn* SeenPawn)
 		ChaseTarget();
 
 		/** Stop the IdlePatrol animation montage */
-		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-		if (AnimInstance)
-		{
-			AnimInstance->Montage_Stop(0.f, IdlePatrolMontage);
-		}
+		MontagePlayer->Stop(EMontageType::EMT_IdlePatrol, 0.f);
 	}
 }
 
@@ -285,12 +420,20 @@ bool AEnemy::IsDead()
 
 void AEnemy::ShowLockedEffect()
 {
-	if (LockedEffectWidget) LockedEffectWidget->SetVisibility(true);
+	const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0);
+	if (ASlashHUD* SlashHUD = PlayerController ? Cast<ASlashHUD>(PlayerController->GetHUD()) : nullptr)
+	{
+		SlashHUD->ShowLockedReticle(this);
+	}
 }
 
 void AEnemy::HideLockedEffect()
 {
-	if (LockedEffectWidget) LockedEffectWidget->SetVisibility(false);
+	const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0);
+	if (ASlashHUD* SlashHUD = PlayerController ? Cast<ASlashHUD>(PlayerController->GetHUD()) : nullptr)
+	{
+		SlashHUD->HideLockedReticle(this);
+	}
 }
 
 bool AEnemy::IsEngaged()
@@ -300,30 +443,15 @@ bool AEnemy::IsEngaged()
 
 void AEnemy::PlayIdlePatrolMontage(const FName& SectionName)
 {
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && IdlePatrolMontage)
-	{
-		AnimInstance->Montage_Play(IdlePatrolMontage);
-		AnimInstance->Montage_JumpToSection(SectionName, IdlePatrolMontage);
-	}
+	// Keeps playing the section it started until FinishIdlePatrol(), Tick asking again changes nothing
+	MontagePlayer->Play(EMontageType::EMT_IdlePatrol, SectionName, /*bSkipIfPlaying*/ true);
 }
 
 FName& AEnemy::IdlePatrolSectionName()
 {
-	const int32 Selection = FMath::RandRange(0, 2);
-	//FName SectionName = FName();
-	switch (Selection)
-	{
-	case 0:
-		IdleSectionName = FName("Patrol1");
-		break;
-	case 1:
-		IdleSectionName = FName("Patrol2");
-		break;
-	case 2:
-		IdleSectionName = FName("Patrol3");
-	}
+	static const FName PatrolSectionNames[] = { FName("Patrol1"), FName("Patrol2"), FName("Patrol3") };
 
+	IdleSectionName = PatrolSectionNames[FMath::RandRange(0, UE_ARRAY_COUNT(PatrolSectionNames) - 1)];
 	return IdleSectionName;
 }
 
@@ -331,13 +459,13 @@ void AEnemy::FinishIdlePatrol()
 {
 	if (EnemyState == EEnemyState::EES_IdlePatrol)
 	{
-		EnemyState = EEnemyState::EES_Patrolling;
+		SetEnemyState(EEnemyState::EES_Patrolling);
 	}
 }
 
 void AEnemy::StartAttackTimer()
 {
-	EnemyState = EEnemyState::EES_Attacking;
+	SetEnemyState(EEnemyState::EES_Attacking);
 	const float AttackTime = FMath::RandRange(AttackMin, AttackMax);
 	GetWorldTimerManager().SetTimer(AttackTimer, this, &AEnemy::Attack, AttackTime);
 }
@@ -350,20 +478,41 @@ void AEnemy::ClearAttackTimer()
 // Called when the game starts or when spawned
 void AEnemy::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Slash_Enemies);
 	Super::BeginPlay();
 
+	MontagePlayer->RegisterMontage(EMontageType::EMT_IdlePatrol, IdlePatrolMontage);
+
 	/** Bind the callback function to the delegate */
 	if (PawnSensing) PawnSensing->OnSeePawn.AddDynamic(this, &AEnemy::PawnSeen);
 	InitializeEnemy();
 
 	Tags.Add(FName("Enemy"));
+
+	SLASH_TRACE_COUNTER_INCREMENT(SlashLiveEnemies);
+	SLASH_TRACE_BOOKMARK(TEXT("Spawn %s"), *GetName());
+}
+
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SLASH_TRACE_COUNTER_DECREMENT(SlashLiveEnemies);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemy::SetEnemyState(EEnemyState NewState)
+{
+	if (EnemyState == NewState) return;
+
+	SLASH_TRACE_BOOKMARK(TEXT("%s: %s -> %s"), *GetName(), *UEnum::GetDisplayValueAsText(EnemyState).ToString(), *UEnum::GetDisplayValueAsText(NewState).ToString());
+	EnemyState = NewState;
 }
 
 void AEnemy::Die_Implementation()
 {
 	Super::Die_Implementation();
 
-	EnemyState = EEnemyState::EES_Dead;
+	SetEnemyState(EEnemyState::EES_Dead);
 	ClearAttackTimer();
 	HideHealthBar();
 	DisableCapsule();
@@ -385,7 +534,7 @@ void AEnemy::Attack()
 	if (CombatTarget == nullptr) return;
 
 	/** Set the state to Engaged as it plays the attack montage */
-	EnemyState = EEnemyState::EES_Engaged;
+	SetEnemyState(EEnemyState::EES_Engaged);
 	PlayAttackMontage();
 }
 
@@ -420,7 +569,9 @@ void AEnemy::AttackEnd()
 	*
 	* This function will be called linked to a anim notify from AM_Attack.
 	*/
-	EnemyState = EEnemyState::EES_NoState;
+	Super::AttackEnd();
+
+	SetEnemyState(EEnemyState::EES_NoState);
 	CheckCombatTarget();
 }
 
@@ -435,10 +586,12 @@ void AEnemy::HandleDamage(float DamageAmount)
 
 void AEnemy::SpawnSoul()
 {
+	LLM_SCOPE_BYTAG(Slash_Pickups);
 	UWorld* World = GetWorld();
 	if (World && SoulClass && Attributes)
 	{
 		const FVector SpawnLocation = GetActorLocation() + FVector{ 0.f, 0.f, 125.f };
+		INC_DWORD_STAT(STAT_SlashSpawns);
 		ASoul* SpawnedSoul = World->SpawnActor<ASoul>(SoulClass, SpawnLocation, GetActorRotation());
 		if (SpawnedSoul)
 		{
@@ -450,8 +603,10 @@ void AEnemy::SpawnSoul()
 }
 
 // Sets default values
-AEnemy::AEnemy()
+AEnemy::AEnemy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
+	LLM_SCOPE_BYTAG(Slash_Enemies);
  	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -461,7 +616,17 @@ AEnemy::AEnemy()
 	GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	GetMesh()->SetGenerateOverlapEvents(true);
 
-	// Construct the health bar widget
+	/**
+	* Skipped animation frames are interpolated. The budget allocator decides which enemies skip, from the
+	*  significance we give it every frame, so it doesn't calculate its own.
+	*/
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		BudgetedMesh->SetAutoCalculateSignificance(false);
+	}
+
+	// Construct the health bar anchor (the bar itself is drawn by ASlashHUD)
 	HealthBarWidget = CreateDefaultSubobject<UMyHealthBarComponent>(TEXT("HealthBar"));
 	// As it has a location in space, we can attach to the root component
 	HealthBarWidget->SetupAttachment(GetRootComponent());
@@ -476,27 +641,36 @@ AEnemy::AEnemy()
 	PawnSensing = CreateDefaultSubobject<UPawnSensingComponent>(TEXT("PawnSensing"));
 	PawnSensing->SightRadius = 4000.f;
 	PawnSensing->SetPeripheralVisionAngle(45.f);
-
-	LockedEffectWidget = CreateDefaultSubobject<ULockedTargetComponent>(TEXT("LockedEffect"));
-	LockedEffectWidget->SetupAttachment(GetRootComponent());
-	LockedEffectWidget->SetWorldLocation(FVector{ GetActorLocation().X, GetActorLocation().Y, GetActorLocation().Z + 15});
 }
 
 void AEnemy::Tick(float DeltaTime)
 {
+	LLM_SCOPE_BYTAG(Slash_Enemies);
+	SLASH_SCOPE(SPB_AI, EnemyTick);
 	Super::Tick(DeltaTime);
 
+	UpdateAnimationSignificance();
+
 	/** 
 	* We need to make sure to not going into the checks if the enemy is in the Dead state.
+	* Dead enemies only tick until their corpse settles.
 	*/
-	if (IsDead()) return;
+	if (IsDead())
+	{
+		SettleCorpse(DeltaTime);
+		return;
+	}
 
 	// Idle Patrol
 	if (IsIdlePatrolling()) // only Paladin has IdlePatrolling...
 	{
 		if (IdlePatrolMontage != nullptr)
 		{
-			PlayIdlePatrolMontage(IdlePatrolSectionName());
+			// Don't even pick a section while one is playing
+			if (!MontagePlayer->IsPlaying(EMontageType::EMT_IdlePatrol))
+			{
+				PlayIdlePatrolMontage(IdlePatrolSectionName());
+			}
 		}
 		else
 		{
@@ -516,12 +690,13 @@ void AEnemy::Tick(float DeltaTime)
 
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	SLASH_SCOPE(SPB_Combat, EnemyTakeDamage);
 	HandleDamage(DamageAmount);
 	CombatTarget = EventInstigator->GetPawn();
 
 	if (IsInsideAttackRadius())
 	{
-		EnemyState = EEnemyState::EES_Attacking;
+		SetEnemyState(EEnemyState::EES_Attacking);
 	}
 	else if (IsOutsideAttackRadius())
 	{
@@ -539,6 +714,12 @@ void AEnemy::Destroyed()
 	}
 }
 
+void AEnemy::GetCombatMontages(TArray<UAnimMontage*>& OutMontages) const
+{
+	Super::GetCombatMontages(OutMontages);
+	OutMontages.Add(IdlePatrolMontage);
+}
+
 void AEnemy::GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter)
 {
 	Super::GetHit_Implementation(ImpactPoint, Hitter);
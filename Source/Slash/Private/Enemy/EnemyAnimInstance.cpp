@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyAnimInstance.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Anim Snapshot"), STAT_SlashEnemyAnimSnapshot, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Enemy Anim Update (worker)"), STAT_SlashEnemyAnimUpdate, STATGROUP_Slash);
+
+void UEnemyAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+
+	Enemy = Cast<AEnemy>(TryGetPawnOwner());
+	if (Enemy)
+	{
+		EnemyMovement = Enemy->GetCharacterMovement();
+	}
+}
+
+void UEnemyAnimInstance::NativeUpdateAnimation(float DeltaTime)
+{
+	SLASH_SCOPE(SPB_Animation, EnemyAnimSnapshot);
+	Super::NativeUpdateAnimation(DeltaTime);
+
+	/** Game thread: only copy, no math */
+	bHasSnapshot = EnemyMovement != nullptr;
+	if (bHasSnapshot)
+	{
+		Snapshot.Velocity = EnemyMovement->Velocity;
+		Snapshot.Rotation = Enemy->GetActorRotation();
+		Snapshot.bIsFalling = EnemyMovement->IsFalling();
+		Snapshot.EnemyState = Enemy->GetEnemyState();
+		Snapshot.DeathPose = Enemy->GetDeathPose();
+	}
+}
+
+void UEnemyAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SlashEnemyAnimUpdate);
+	Super::NativeThreadSafeUpdateAnimation(DeltaTime);
+
+	if (!bHasSnapshot) return;
+
+	GroundSpeed = Snapshot.Velocity.Size2D();
+	Direction = CalculateDirection(Snapshot.Velocity, Snapshot.Rotation);
+	IsFalling = Snapshot.bIsFalling;
+	EnemyState = Snapshot.EnemyState;
+	bIsDead = Snapshot.EnemyState == EEnemyState::EES_Dead;
+	DeathPose = Snapshot.DeathPose;
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/HealthBarSubsystem.h"
+#include "Components/SceneComponent.h"
+
+int32 UHealthBarSubsystem::RegisterBar(USceneComponent* Anchor)
+{
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop();
+		Anchors[Slot] = Anchor;
+		Percents[Slot] = 1.f;
+		Visible[Slot] = 0;
+	}
+	else
+	{
+		Slot = Anchors.Add(Anchor);
+		Percents.Add(1.f);
+		Visible.Add(0);
+	}
+	return Slot;
+}
+
+void UHealthBarSubsystem::UnregisterBar(int32 Slot)
+{
+	if (!Anchors.IsValidIndex(Slot) || !Anchors[Slot].IsValid()) return;
+
+	Anchors[Slot].Reset();
+	Visible[Slot] = 0;
+	FreeSlots.Add(Slot);
+}
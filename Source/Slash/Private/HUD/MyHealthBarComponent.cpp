@@ -2,38 +2,49 @@
 
 
 #include "HUD/MyHealthBarComponent.h"
+#include "Performance/SlashMemory.h"
 
-/** To cast to a HealthBar */
-#include "HUD/HealthBar.h"
+/** The bars are drawn by the HUD from here */
+#include "HUD/HealthBarSubsystem.h"
 
-/** Access SetPercent */
-#include "Components/ProgressBar.h"
+void UMyHealthBarComponent::BeginPlay()
+{
+   LLM_SCOPE_BYTAG(Slash_HUD);
+   Super::BeginPlay();
 
-void UMyHealthBarComponent::SetHealthBarPercent(float Percent)
+   if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>())
+   {
+      BarSlot = HealthBars->RegisterBar(this);
+      HealthBars->SetVisible(BarSlot, IsVisible());
+   }
+}
+
+void UMyHealthBarComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+   if (UHealthBarSubsystem* HealthBars = GetWorld() ? GetWorld()->GetSubsystem<UHealthBarSubsystem>() : nullptr)
+   {
+      HealthBars->UnregisterBar(BarSlot);
+   }
+   BarSlot = INDEX_NONE;
+
+   Super::EndPlay(EndPlayReason);
+}
+
+void UMyHealthBarComponent::OnVisibilityChanged()
 {
-   /** 
-   * Like it was before, as this function will be called many times, the cast would also happened many many many times!
-   * And that's not good since the cast is super expensive because it keeps checking if it's possible to cast through
-   *  all other classes in the hierarchy.
-   * So, we have HealthBarWidget as a member variable and before casting, we check if it's nullptr, meaning it was
-   *  not casted before.
-   * To make sure that HealthBarWidget is initialized to a null pointer, we can use UPROPERTY().
-   */
-
-   if (HealthBarWidget == nullptr)
+   Super::OnVisibilityChanged();
+
+   if (UHealthBarSubsystem* HealthBars = GetWorld() ? GetWorld()->GetSubsystem<UHealthBarSubsystem>() : nullptr)
    {
-      // Set HealthBarWidget by casting UUserWidget* to a HealthBar* type which is a child of UUserWidget!
-      HealthBarWidget = Cast<UHealthBar>(GetUserWidgetObject());
+      HealthBars->SetVisible(BarSlot, IsVisible());
    }
+}
 
-   // valid pointer if the cast succeeded (NOT NULL). As we access HealthBar pointer, check it too
-   if (HealthBarWidget && HealthBarWidget->HealthBar) // check from left to right
+void UMyHealthBarComponent::SetHealthBarPercent(float Percent)
+{
+   // Just a write in the health array, no widget to touch
+   if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>())
    {
-      /** 
-      * Set the percentage of the progress bar.
-      * For that we can accesss the progress bar of WBP_HealthBar through HealthBar class that has a HealthBar
-      *  UProgressBar pointer bound to the prograss bar in BP!
-      */
-      HealthBarWidget->HealthBar->SetPercent(Percent);
+      HealthBars->SetPercent(BarSlot, Percent);
    }
 }
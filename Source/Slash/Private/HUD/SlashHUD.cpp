@@ -2,10 +2,40 @@
 
 
 #include "HUD/SlashHUD.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashMemory.h"
 #include "HUD/SlashOverlay.h"
+#include "HUD/HealthBarSubsystem.h"
+#include "Blueprint/UserWidget.h"
+
+/** Perf overlay */
+#include "HAL/IConsoleManager.h"
+#include "EngineUtils.h"
+#include "Engine/Canvas.h"
+#include "Enemy/Enemy.h"
+#include "Items/PickupSubsystem.h"
+#include "Items/InstancedPickupSubsystem.h"
+#include "Items/ItemMotionSubsystem.h"
+#include "Breakable/DebrisSubsystem.h"
+#include "NiagaraComponent.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("HUD DrawHUD"), STAT_SlashDrawHUD, STATGROUP_Slash);
+
+DEFINE_LOG_CATEGORY_STATIC(LogSlashHUD, Log, All);
+
+namespace
+{
+   TAutoConsoleVariable<bool> CVarPerfOverlay(
+      TEXT("Slash.PerfOverlay"),
+      false,
+      TEXT("Show the Slash perf overlay: what each system is working on and its game thread time (not in shipping builds)")
+   );
+}
 
 void ASlashHUD::BeginPlay()
 {
+   LLM_SCOPE_BYTAG(Slash_HUD);
    Super::BeginPlay();
 
    /** 
@@ -27,5 +57,212 @@ void ASlashHUD::BeginPlay()
          SlashOverlay = CreateWidget<USlashOverlay>(Controller, SlashOverlayClass);
          SlashOverlay->AddToViewport();
       }
+
+      if (Controller && LockedReticleClass)
+      {
+         LockedReticle = CreateWidget<UUserWidget>(Controller, LockedReticleClass);
+         LockedReticle->AddToViewport();
+         LockedReticle->SetAlignmentInViewport(FVector2D(0.5f, 0.5f));
+         LockedReticle->SetVisibility(ESlateVisibility::Collapsed);
+      }
+      else if (LockedReticleClass == nullptr)
+      {
+         UE_LOG(LogSlashHUD, Warning, TEXT("%s has no LockedReticleClass, the locked enemy gets a canvas marker instead"), *GetClass()->GetName());
+      }
+   }
+}
+
+void ASlashHUD::DrawHUD()
+{
+   LLM_SCOPE_BYTAG(Slash_HUD);
+   SLASH_SCOPE(SPB_HUD, DrawHUD);
+   Super::DrawHUD();
+
+   if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>())
+   {
+      DrawHealthBars(HealthBars);
+   }
+   if (LockedReticle)
+   {
+      UpdateLockedReticle();
+   }
+   else
+   {
+      DrawLockedMarker();
+   }
+
+   if (CVarPerfOverlay.GetValueOnGameThread())
+   {
+      DrawPerfOverlay();
+   }
+}
+
+void ASlashHUD::ShowLockedReticle(AActor* Target)
+{
+   LockedTarget = Target;
+   UpdateLockedReticle();
+}
+
+void ASlashHUD::HideLockedReticle(const AActor* Target)
+{
+   if (LockedTarget.Get() != Target) return;
+
+   LockedTarget.Reset();
+   UpdateLockedReticle();
+}
+
+void ASlashHUD::UpdateLockedReticle()
+{
+   if (LockedReticle == nullptr) return;
+
+   const AActor* Target = LockedTarget.Get();
+   FVector2D ScreenLocation;
+   const bool bOnScreen = Target && PlayerOwner &&
+      PlayerOwner->ProjectWorldLocationToScreen(Target->GetActorLocation() + LockedReticleOffset, ScreenLocation);
+
+   if (!bOnScreen)
+   {
+      if (LockedReticle->GetVisibility() != ESlateVisibility::Collapsed)
+      {
+         LockedReticle->SetVisibility(ESlateVisibility::Collapsed);
+      }
+      return;
+   }
+
+   LockedReticle->SetPositionInViewport(ScreenLocation, true);
+   if (LockedReticle->GetVisibility() != ESlateVisibility::HitTestInvisible)
+   {
+      LockedReticle->SetVisibility(ESlateVisibility::HitTestInvisible);
+   }
+}
+
+void ASlashHUD::DrawLockedMarker()
+{
+   const AActor* Target = LockedTarget.Get();
+   if (Target == nullptr || Canvas == nullptr) return;
+
+   // Z is 0 behind the camera
+   const FVector ScreenLocation = Project(Target->GetActorLocation() + LockedReticleOffset, true);
+   if (ScreenLocation.Z <= 0.f) return;
+
+   const float X = ScreenLocation.X;
+   const float Y = ScreenLocation.Y;
+   const float Size = LockedMarkerSize;
+   DrawLine(X - Size, Y, X, Y - Size, LockedMarkerColor, 2.f);
+   DrawLine(X, Y - Size, X + Size, Y, LockedMarkerColor, 2.f);
+   DrawLine(X + Size, Y, X, Y + Size, LockedMarkerColor, 2.f);
+   DrawLine(X, Y + Size, X - Size, Y, LockedMarkerColor, 2.f);
+}
+
+void ASlashHUD::DrawHealthBars(UHealthBarSubsystem* HealthBars)
+{
+   if (Canvas == nullptr || PlayerOwner == nullptr || PlayerOwner->PlayerCameraManager == nullptr) return;
+
+   const FVector ViewLocation = PlayerOwner->PlayerCameraManager->GetCameraLocation();
+   const double MaxDistanceSquared = FMath::Square(MaxHealthBarDistance);
+
+   for (int32 Slot = 0; Slot < HealthBars->GetNumSlots(); ++Slot)
+   {
+      const USceneComponent* Anchor = HealthBars->GetAnchor(Slot);
+      if (Anchor == nullptr || !HealthBars->IsVisible(Slot)) continue;
+
+      const float Percent = HealthBars->GetPercent(Slot);
+      if (bOnlyDamagedHealthBars && Percent >= 1.f) continue;
+
+      const FVector Location = Anchor->GetComponentLocation();
+      if (FVector::DistSquared(Location, ViewLocation) > MaxDistanceSquared) continue;
+
+      // The renderer already knows if the enemy was occluded, no need for a trace
+      const AActor* Owner = Anchor->GetOwner();
+      if (Owner && !Owner->WasRecentlyRendered(0.1f)) continue;
+
+      // Z is 0 behind the camera
+      const FVector ScreenLocation = Project(Location, true);
+      if (ScreenLocation.Z <= 0.f) continue;
+
+      const float Left = ScreenLocation.X - HealthBarSize.X * 0.5f;
+      const float Top = ScreenLocation.Y - HealthBarSize.Y * 0.5f;
+      DrawRect(HealthBarBackgroundColor, Left, Top, HealthBarSize.X, HealthBarSize.Y);
+      DrawRect(HealthBarColor, Left, Top, HealthBarSize.X * FMath::Clamp(Percent, 0.f, 1.f), HealthBarSize.Y);
+   }
+}
+
+void ASlashHUD::DrawPerfOverlay()
+{
+#if SLASH_PERF_COUNTERS
+   if (Canvas == nullptr) return;
+
+   UWorld* World = GetWorld();
+   TArray<FString> Lines;
+
+   /** Enemies */
+   int32 NumPerState[static_cast<int32>(EEnemyState::EES_Engaged) + 1] = {};
+   int32 NumEnemies = 0;
+   int32 NumTicking = 0;
+   int32 NumWaitingForPath = 0;
+   for (TActorIterator<AEnemy> It(World); It; ++It)
+   {
+      const AEnemy* Enemy = *It;
+      ++NumEnemies;
+      ++NumPerState[static_cast<int32>(Enemy->GetEnemyState())];
+      NumTicking += Enemy->IsActorTickEnabled() ? 1 : 0;
+      NumWaitingForPath += Enemy->IsWaitingForPath() ? 1 : 0;
+   }
+   Lines.Add(FString::Printf(TEXT("Enemies: %d (%d ticking, %d waiting for a path)"), NumEnemies, NumTicking, NumWaitingForPath));
+
+   const UEnum* StateEnum = StaticEnum<EEnemyState>();
+   for (int32 State = 0; State < UE_ARRAY_COUNT(NumPerState); ++State)
+   {
+      if (NumPerState[State] == 0) continue;
+      Lines.Add(FString::Printf(TEXT("   %s: %d"), *StateEnum->GetDisplayNameTextByValue(State).ToString(), NumPerState[State]));
+   }
+
+   /** Pickups and items */
+   const UPickupSubsystem* Pickups = World->GetSubsystem<UPickupSubsystem>();
+   const UInstancedPickupSubsystem* InstancedPickups = World->GetSubsystem<UInstancedPickupSubsystem>();
+   const UItemMotionSubsystem* ItemMotion = World->GetSubsystem<UItemMotionSubsystem>();
+   Lines.Add(FString::Printf(TEXT("Pickups: %d actors, %d instanced"),
+      Pickups ? Pickups->GetNumPickups() : 0,
+      InstancedPickups ? InstancedPickups->GetNumInstancedPickups() : 0));
+   Lines.Add(FString::Printf(TEXT("Items: %d hovering, %d souls descending"),
+      ItemMotion ? ItemMotion->GetNumHoveringItems() : 0,
+      ItemMotion ? ItemMotion->GetNumDescendingSouls() : 0));
+
+   /** FX: there's no registry for them, but this only runs while the overlay is shown */
+   int32 NumActiveFX = 0;
+   for (TObjectIterator<UNiagaraComponent> It; It; ++It)
+   {
+      NumActiveFX += (It->GetWorld() == World && It->IsActive()) ? 1 : 0;
+   }
+   for (TObjectIterator<UParticleSystemComponent> It; It; ++It)
+   {
+      NumActiveFX += (It->GetWorld() == World && It->IsActive()) ? 1 : 0;
+   }
+   Lines.Add(FString::Printf(TEXT("Active FX: %d"), NumActiveFX));
+
+   const UDebrisSubsystem* Debris = World->GetSubsystem<UDebrisSubsystem>();
+   Lines.Add(FString::Printf(TEXT("Debris: %d pieces simulating, %d breakables"),
+      Debris ? Debris->GetNumSimulatingPieces() : 0,
+      Debris ? Debris->GetNumDebris() : 0));
+
+   const FSlashPerfCounters& Counters = FSlashPerfCounters::Get();
+   Lines.Add(FString::Printf(TEXT("Damage events last frame: %d"), Counters.GetDamageEventsLastFrame()));
+
+   /** Game thread time */
+   double TotalMs = 0.0;
+   for (int32 Bucket = 0; Bucket < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Bucket)
+   {
+      const double Ms = Counters.GetBucketMs(static_cast<ESlashPerfBucket>(Bucket));
+      TotalMs += Ms;
+      Lines.Add(FString::Printf(TEXT("   %s: %.3f ms"), FSlashPerfCounters::GetBucketName(static_cast<ESlashPerfBucket>(Bucket)), Ms));
+   }
+   Lines.Insert(FString::Printf(TEXT("Game thread: %.3f ms"), TotalMs), Lines.Num() - static_cast<int32>(ESlashPerfBucket::SPB_MAX));
+
+   float Y = PerfOverlayPosition.Y;
+   for (const FString& Line : Lines)
+   {
+      DrawText(Line, PerfOverlayColor, PerfOverlayPosition.X, Y);
+      Y += 14.f;
    }
+#endif
 }
@@ -2,45 +2,72 @@
 
 
 #include "HUD/SlashOverlay.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashMemory.h"
 #include "Components/ProgressBar.h"
 #include "Components/TextBlock.h"
+#include "Components/InvalidationBox.h"
 
-void USlashOverlay::SetHealthBarPercent(float Percent)
+DECLARE_CYCLE_STAT(TEXT("Overlay Setters"), STAT_SlashOverlaySetters, STATGROUP_Slash);
+
+void USlashOverlay::NativeConstruct()
 {
-   if (HealthProgressBar)
+   LLM_SCOPE_BYTAG(Slash_HUD);
+   Super::NativeConstruct();
+
+   if (OverlayInvalidationBox)
    {
-      HealthProgressBar->SetPercent(Percent);
+      OverlayInvalidationBox->SetCanCache(true);
    }
 }
 
+bool USlashOverlay::SetBarPercent(UProgressBar* Bar, float Percent, int32& LastStep)
+{
+   if (Bar == nullptr) return false;
+
+   const int32 Step = FMath::RoundToInt(FMath::Clamp(Percent, 0.f, 1.f) * BarSteps);
+   if (Step == LastStep) return false;
+
+   LastStep = Step;
+   Bar->SetPercent(static_cast<float>(Step) / BarSteps);
+   return true;
+}
+
+void USlashOverlay::SetNumberText(UTextBlock* Text, int32 Value, int32& LastValue)
+{
+   if (Text == nullptr || Value == LastValue) return;
+
+   LastValue = Value;
+   // Same look as the old Printf("%d"): no digit grouping
+   Text->SetText(FText::AsNumber(Value, &FNumberFormattingOptions::DefaultNoGrouping()));
+}
+
+void USlashOverlay::SetHealthBarPercent(float Percent)
+{
+   SLASH_SCOPE(SPB_HUD, OverlaySetters);
+   SetBarPercent(HealthProgressBar, Percent, LastHealthStep);
+}
+
 void USlashOverlay::SetStaminaBarPercent(float Percent)
 {
-   if (StaminaProgressBar)
-   {
-      StaminaProgressBar->SetPercent(Percent);
-   }
+   SLASH_SCOPE(SPB_HUD, OverlaySetters);
+   SetBarPercent(StaminaProgressBar, Percent, LastStaminaStep);
 }
 
 void USlashOverlay::SetGold(int32 Gold)
 {
-   if (GoldText)
-   {
-      GoldText->SetText(FText::FromString(FString::Printf(TEXT("%d"), Gold)));
-   }
+   SLASH_SCOPE(SPB_HUD, OverlaySetters);
+   SetNumberText(GoldText, Gold, LastGold);
 }
 
 void USlashOverlay::SetSouls(int32 Souls)
 {
-   if (SoulsText)
-   {
-      SoulsText->SetText(FText::FromString(FString::Printf(TEXT("%d"), Souls)));
-   }
+   SLASH_SCOPE(SPB_HUD, OverlaySetters);
+   SetNumberText(SoulsText, Souls, LastSouls);
 }
 
 void USlashOverlay::SetBooks(int32 Books)
 {
-   if (BooksText)
-   {
-      BooksText->SetText(FText::FromString(FString::Printf(TEXT("%d"), Books)));
-   }
+   SLASH_SCOPE(SPB_HUD, OverlaySetters);
+   SetNumberText(BooksText, Books, LastBooks);
 }
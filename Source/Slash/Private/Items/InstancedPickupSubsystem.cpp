@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/InstancedPickupSubsystem.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashMemory.h"
+#include "Items/Item.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Instanced Pickups Tick"), STAT_SlashInstancedPickupsTick, STATGROUP_Slash);
+
+bool UInstancedPickupSubsystem::AddInstancedPickup(AItem* Item)
+{
+	LLM_SCOPE_BYTAG(Slash_Pickups);
+	if (Item == nullptr || Item->GetItemMesh()->GetStaticMesh() == nullptr) return false;
+
+	FInstancedPickup& Pickup = Pickups.AddDefaulted_GetRef();
+	Pickup.Class = Item->GetClass();
+	// Without the hover offset, so going back and forth between actor and instance doesn't make it climb
+	Pickup.Transform = Item->GetRestTransform();
+	Pickup.Value = Item->GetPickupValue();
+	Pickup.MeshIndex = FindOrAddMesh(Item);
+
+	FPickupMesh& PickupMesh = Meshes[Pickup.MeshIndex];
+	// The mesh is the root component, so this is identity unless a Blueprint moves the mesh under another root
+	const FTransform MeshToActor = Item->GetItemMesh()->GetComponentTransform().GetRelativeTransform(Item->GetActorTransform());
+	const FTransform InstanceTransform = MeshToActor * Pickup.Transform;
+	if (PickupMesh.FreeInstances.Num() > 0)
+	{
+		Pickup.InstanceIndex = PickupMesh.FreeInstances.Pop();
+		PickupMesh.Instances->UpdateInstanceTransform(Pickup.InstanceIndex, InstanceTransform, true, true);
+	}
+	else
+	{
+		Pickup.InstanceIndex = PickupMesh.Instances->AddInstance(InstanceTransform, true);
+	}
+
+	Item->Destroy();
+	SLASH_TRACE_COUNTER_SET(SlashInstancedPickups, Pickups.Num());
+	return true;
+}
+
+int32 UInstancedPickupSubsystem::FindOrAddMesh(AItem* Item)
+{
+	UStaticMeshComponent* ItemMesh = Item->GetItemMesh();
+	UStaticMesh* Mesh = ItemMesh->GetStaticMesh();
+
+	const int32 Found = Meshes.IndexOfByPredicate([Mesh](const FPickupMesh& PickupMesh) { return PickupMesh.Mesh == Mesh; });
+	if (Found != INDEX_NONE) return Found;
+
+	if (RendererActor == nullptr)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		RendererActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(RendererActor);
+	Instances->SetStaticMesh(Mesh);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetCanEverAffectNavigation(false);
+	// Same look as the first item using this mesh
+	for (int32 MaterialIndex = 0; MaterialIndex < ItemMesh->GetNumMaterials(); ++MaterialIndex)
+	{
+		Instances->SetMaterial(MaterialIndex, ItemMesh->GetMaterial(MaterialIndex));
+	}
+	if (RendererActor->GetRootComponent() == nullptr)
+	{
+		RendererActor->SetRootComponent(Instances);
+	}
+	else
+	{
+		Instances->SetupAttachment(RendererActor->GetRootComponent());
+	}
+	Instances->RegisterComponent();
+	InstanceComponents.Add(Instances);
+
+	FPickupMesh& PickupMesh = Meshes.AddDefaulted_GetRef();
+	PickupMesh.Mesh = Mesh;
+	PickupMesh.Instances = Instances;
+	return Meshes.Num() - 1;
+}
+
+void UInstancedPickupSubsystem::Tick(float DeltaTime)
+{
+	LLM_SCOPE_BYTAG(Slash_Pickups);
+	SLASH_SCOPE(SPB_Pickups, InstancedPickupsTick);
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval) return;
+	TimeSinceUpdate = 0.f;
+
+	const APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+	if (Player == nullptr) return;
+
+	const FVector PlayerLocation = Player->GetActorLocation();
+	DemotePickups(PlayerLocation);
+	PromotePickups(PlayerLocation);
+
+	SLASH_TRACE_COUNTER_SET(SlashInstancedPickups, Pickups.Num());
+}
+
+void UInstancedPickupSubsystem::PromotePickups(const FVector& PlayerLocation)
+{
+	const double PromoteRadiusSquared = FMath::Square(PromoteRadius);
+
+	for (int32 Index = Pickups.Num() - 1; Index >= 0; --Index)
+	{
+		const FInstancedPickup& Pickup = Pickups[Index];
+		if (FVector::DistSquared(Pickup.Transform.GetLocation(), PlayerLocation) > PromoteRadiusSquared) continue;
+
+		/** Hide the instance and keep its slot for the next pickup using this mesh */
+		FPickupMesh& PickupMesh = Meshes[Pickup.MeshIndex];
+		FTransform Hidden = Pickup.Transform;
+		Hidden.SetScale3D(FVector::ZeroVector);
+		PickupMesh.Instances->UpdateInstanceTransform(Pickup.InstanceIndex, Hidden, true, true);
+		PickupMesh.FreeInstances.Add(Pickup.InstanceIndex);
+
+		INC_DWORD_STAT(STAT_SlashSpawns);
+		AItem* Item = GetWorld()->SpawnActorDeferred<AItem>(Pickup.Class, Pickup.Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Item)
+		{
+			Item->SetPickupValue(Pickup.Value);
+			Item->MarkPromotedFromInstance();
+			UGameplayStatics::FinishSpawningActor(Item, Pickup.Transform);
+			PromotedItems.Add(Item);
+		}
+
+		Pickups.RemoveAtSwap(Index);
+	}
+}
+
+void UInstancedPickupSubsystem::DemotePickups(const FVector& PlayerLocation)
+{
+	const double DemoteRadiusSquared = FMath::Square(DemoteRadius);
+
+	for (int32 Index = PromotedItems.Num() - 1; Index >= 0; --Index)
+	{
+		AItem* Item = PromotedItems[Index].Get();
+
+		// Picked up (or equipped, for a weapon): it's a real actor for good
+		if (Item == nullptr || !Item->IsPickupHovering())
+		{
+			PromotedItems.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (FVector::DistSquared(Item->GetActorLocation(), PlayerLocation) > DemoteRadiusSquared)
+		{
+			PromotedItems.RemoveAtSwap(Index);
+			AddInstancedPickup(Item);
+		}
+	}
+}
+
+TStatId UInstancedPickupSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInstancedPickupSubsystem, STATGROUP_Tickables);
+}
+
+bool UInstancedPickupSubsystem::IsTickable() const
+{
+	return Pickups.Num() > 0 || PromotedItems.Num() > 0;
+}
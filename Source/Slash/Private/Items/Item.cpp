@@ -2,18 +2,39 @@
 
 
 #include "Items/Item.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashTrace.h"
+#include "Performance/SlashMemory.h"
 #include "Slash/DebugMacros.h"
 #include "Components/SphereComponent.h"
 #include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "Interfaces/PickupInterface.h"
 #include "Kismet/GameplayStatics.h"
+#include "Items/ItemMotionSubsystem.h"
+#include "Items/PickupSubsystem.h"
+#include "Items/InstancedPickupSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Pickup Overlap"), STAT_SlashItemPickupOverlap, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Item Pickup FX"), STAT_SlashItemPickupFX, STATGROUP_Slash);
+
+namespace
+{
+	/**
+	* The hover used to add TransformedSin() to the height every frame, so how high it went depended on the frame
+	*  rate. We now set the height directly (the integral of that sine), scaled to look like it did at 60 fps.
+	*/
+	constexpr float HoverReferenceFrameRate = 60.f;
+}
 
 // Sets default values
 AItem::AItem()
 {
+	LLM_SCOPE_BYTAG(Slash_Pickups);
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+	// Children that need Tick() (like the Soul) turn it on. Hovering is done by UItemMotionSubsystem
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	// Construct the mesh component and assign it to the root component
 	ItemMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ItemMeshComponent"));
@@ -38,11 +59,94 @@ AItem::AItem()
 // Called when the game starts or when spawned
 void AItem::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Slash_Pickups);
 	Super::BeginPlay();
 
+	/**
+	* Only drawn as an instance until the player gets close: this actor is destroyed. Level-placed items only, a
+	*  spawned one (loot) is still being set up by its spawner and often right next to the player anyway.
+	*/
+	if (bRenderInstanced && !bPromotedFromInstance && HasAnyFlags(RF_WasLoaded) && ItemState == EItemState::EIS_Hovering)
+	{
+		UInstancedPickupSubsystem* InstancedPickups = GetWorld()->GetSubsystem<UInstancedPickupSubsystem>();
+		if (InstancedPickups && InstancedPickups->AddInstancedPickup(this)) return;
+	}
+
 	/** Bind callbacks to their respective delegates */
 	Sphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
 	Sphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
+
+	/** With the pickup index, the Sphere doesn't need to be in the physics scene at all */
+	if (ItemState == EItemState::EIS_Hovering && UPickupSubsystem::IsIndexEnabled())
+	{
+		if (UPickupSubsystem* Pickups = GetWorld()->GetSubsystem<UPickupSubsystem>())
+		{
+			Sphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			Pickups->RegisterPickup(this, Sphere->GetScaledSphereRadius());
+			bRegisteredForPickup = true;
+		}
+	}
+
+	if (ItemState == EItemState::EIS_Hovering && !bHoverInMaterial)
+	{
+		if (UItemMotionSubsystem* ItemMotion = GetWorld()->GetSubsystem<UItemMotionSubsystem>())
+		{
+			ItemMotion->RegisterHoveringItem(this);
+			bRegisteredForHover = true;
+		}
+	}
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopHovering();
+	StopBeingPickup();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AItem::StopHovering()
+{
+	if (!bRegisteredForHover) return;
+	bRegisteredForHover = false;
+
+	if (UItemMotionSubsystem* ItemMotion = GetWorld() ? GetWorld()->GetSubsystem<UItemMotionSubsystem>() : nullptr)
+	{
+		ItemMotion->UnregisterHoveringItem(this);
+	}
+}
+
+void AItem::StopBeingPickup()
+{
+	if (!bRegisteredForPickup) return;
+	bRegisteredForPickup = false;
+
+	if (UPickupSubsystem* Pickups = GetWorld() ? GetWorld()->GetSubsystem<UPickupSubsystem>() : nullptr)
+	{
+		Pickups->UnregisterPickup(this);
+	}
+}
+
+void AItem::NotifyPickupEnter(AActor* Picker)
+{
+	OnSphereOverlap(Sphere, Picker, Picker ? Picker->GetRootComponent() : nullptr, 0, false, FHitResult());
+}
+
+void AItem::NotifyPickupExit(AActor* Picker)
+{
+	OnSphereEndOverlap(Sphere, Picker, Picker ? Picker->GetRootComponent() : nullptr, 0);
+}
+
+FVector AItem::GetPickupLocation() const
+{
+	return Sphere->GetComponentLocation();
+}
+
+FTransform AItem::GetRestTransform() const
+{
+	FTransform RestTransform = GetActorTransform();
+	RestTransform.AddToTranslation(FVector(0.f, 0.f, -AppliedHoverOffset));
+	return RestTransform;
 }
 
 float AItem::TransformedSin()
@@ -57,6 +161,7 @@ float AItem::TransformedCos()
 
 void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	SLASH_SCOPE(SPB_Pickups, ItemPickupOverlap);
 	IPickupInterface* PickupInterface = Cast<IPickupInterface>(OtherActor);
 	if (PickupInterface)
 	{
@@ -66,6 +171,7 @@ void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Ot
 
 void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
+	SLASH_SCOPE(SPB_Pickups, ItemPickupOverlap);
 	IPickupInterface* PickupInterface = Cast<IPickupInterface>(OtherActor);
 	if (PickupInterface)
 	{
@@ -75,13 +181,16 @@ void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 
 void AItem::SpawnPickupSystem()
 {
+	SLASH_SCOPE(SPB_FX, ItemPickupFX);
 	if (PickupEffect)
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+		INC_DWORD_STAT(STAT_SlashSpawns);
+		UNiagaraComponent* Effect = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
 			this,
 			PickupEffect,
 			GetActorLocation()
 		);
+		SLASH_TRACE_FX(Effect);
 	}
 }
 
@@ -100,11 +209,22 @@ void AItem::SpawnPickupSound()
 void AItem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+}
+
+void AItem::TickHover(float DeltaTime, bool bVisible)
+{
 	RunningTime += DeltaTime;
 
-	if (ItemState == EItemState::EIS_Hovering)
+	if (!bVisible || ItemState != EItemState::EIS_Hovering) return;
+
+	/** Only move by the difference from the last offset we applied, so a Soul can drift down at the same time */
+	const float HoverOffset = (Amplitude - TransformedCos()) * HoverReferenceFrameRate / TimeConstant;
+	AddActorWorldOffset(FVector(0.f, 0.f, HoverOffset - AppliedHoverOffset));
+	AppliedHoverOffset = HoverOffset;
+
+	if (bSpin)
 	{
-		AddActorWorldOffset(FVector(0.f, 0.f, TransformedSin()));
+		AddActorWorldRotation(FRotator(0.f, RotationRate * DeltaTime, 0.f));
 	}
 }
 
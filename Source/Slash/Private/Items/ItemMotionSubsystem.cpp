@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/ItemMotionSubsystem.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashMemory.h"
+#include "Items/Item.h"
+#include "Items/Soul.h"
+#include "HAL/IConsoleManager.h"
+
+/** Soul descent */
+#include "NavigationSystem.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Motion Tick"), STAT_SlashItemMotionTick, STATGROUP_Slash);
+
+namespace
+{
+	void ReportItemMotion(UWorld* World)
+	{
+		if (const UItemMotionSubsystem* ItemMotion = World ? World->GetSubsystem<UItemMotionSubsystem>() : nullptr)
+		{
+			ItemMotion->ReportMotionCost();
+		}
+	}
+
+	FAutoConsoleCommandWithWorld ReportItemMotionCommand(
+		TEXT("Slash.Items.ReportMotion"),
+		TEXT("Print the number of hovering items and the game thread time spent moving them"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&ReportItemMotion)
+	);
+}
+
+void UItemMotionSubsystem::RegisterHoveringItem(AItem* Item)
+{
+	LLM_SCOPE_BYTAG(Slash_Pickups);
+	if (Item)
+	{
+		HoveringItems.AddUnique(Item);
+	}
+}
+
+void UItemMotionSubsystem::UnregisterHoveringItem(AItem* Item)
+{
+	HoveringItems.RemoveSwap(Item);
+}
+
+void UItemMotionSubsystem::StartDescent(ASoul* Soul, double TargetZ, double Speed, UCurveFloat* Curve)
+{
+	if (Soul == nullptr) return;
+
+	const double StartZ = Soul->GetActorLocation().Z;
+	if (StartZ <= TargetZ || Speed <= 0.0) return;
+
+	StopDescent(Soul);
+
+	DescendingSouls.Add(Soul);
+	DescentCurves.Add(Curve);
+	DescentStartZ.Add(StartZ);
+	DescentTargetZ.Add(TargetZ);
+	DescentAppliedZ.Add(StartZ);
+	DescentElapsed.Add(0.f);
+	DescentDuration.Add((StartZ - TargetZ) / Speed);
+}
+
+void UItemMotionSubsystem::StopDescent(ASoul* Soul)
+{
+	const int32 Index = DescendingSouls.Find(Soul);
+	if (Index != INDEX_NONE)
+	{
+		RemoveDescentAt(Index);
+	}
+}
+
+void UItemMotionSubsystem::RemoveDescentAt(int32 Index)
+{
+	DescendingSouls.RemoveAtSwap(Index);
+	DescentCurves.RemoveAtSwap(Index);
+	DescentStartZ.RemoveAtSwap(Index);
+	DescentTargetZ.RemoveAtSwap(Index);
+	DescentAppliedZ.RemoveAtSwap(Index);
+	DescentElapsed.RemoveAtSwap(Index);
+	DescentDuration.RemoveAtSwap(Index);
+}
+
+void UItemMotionSubsystem::TickDescent(float DeltaTime)
+{
+	for (int32 Index = DescendingSouls.Num() - 1; Index >= 0; --Index)
+	{
+		ASoul* Soul = DescendingSouls[Index];
+		if (!IsValid(Soul))
+		{
+			RemoveDescentAt(Index);
+			continue;
+		}
+
+		DescentElapsed[Index] += DeltaTime;
+		const float Alpha = FMath::Min(DescentElapsed[Index] / DescentDuration[Index], 1.f);
+		const float Travelled = DescentCurves[Index] ? DescentCurves[Index]->GetFloatValue(Alpha) : Alpha;
+		const double NewZ = FMath::Lerp(DescentStartZ[Index], DescentTargetZ[Index], static_cast<double>(Travelled));
+
+		Soul->AddActorWorldOffset(FVector(0., 0., NewZ - DescentAppliedZ[Index]));
+		DescentAppliedZ[Index] = NewZ;
+
+		// Settled: nothing else to do for this soul
+		if (Alpha >= 1.f)
+		{
+			RemoveDescentAt(Index);
+		}
+	}
+}
+
+bool UItemMotionSubsystem::FindGroundHeight(const FVector& Location, const AActor* IgnoredActor, double& OutGroundZ)
+{
+	/** Cells are GroundCellSize wide, and tall enough that souls dropped on a bridge don't share the floor below */
+	const FIntVector Cell(
+		FMath::FloorToInt(Location.X / GroundCellSize),
+		FMath::FloorToInt(Location.Y / GroundCellSize),
+		FMath::FloorToInt(Location.Z / (GroundCellSize * 5.f))
+	);
+	if (const double* CachedZ = GroundHeightCache.Find(Cell))
+	{
+		OutGroundZ = *CachedZ;
+		return true;
+	}
+
+	UWorld* World = GetWorld();
+	bool bFound = false;
+
+	if (UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World))
+	{
+		// Only look below the soul, like the trace did
+		const FVector QueryCenter = Location - FVector(0., 0., 1000.);
+		FNavLocation NavLocation;
+		if (NavSystem->ProjectPointToNavigation(QueryCenter, NavLocation, FVector(50., 50., 1000.)))
+		{
+			OutGroundZ = NavLocation.Location.Z;
+			bFound = true;
+		}
+	}
+
+	if (!bFound)
+	{
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(IgnoredActor);
+		FHitResult HitResult;
+		INC_DWORD_STAT(STAT_SlashTraces);
+		if (World->LineTraceSingleByObjectType(HitResult, Location, Location - FVector(0., 0., 2000.), FCollisionObjectQueryParams(ECC_WorldStatic), QueryParams))
+		{
+			OutGroundZ = HitResult.ImpactPoint.Z;
+			bFound = true;
+		}
+	}
+
+	if (bFound)
+	{
+		GroundHeightCache.Add(Cell, OutGroundZ);
+	}
+	return bFound;
+}
+
+void UItemMotionSubsystem::Tick(float DeltaTime)
+{
+	SLASH_SCOPE(SPB_Items, ItemMotionTick);
+	Super::Tick(DeltaTime);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	NumMovedLastUpdate = 0;
+	for (AItem* Item : HoveringItems)
+	{
+		if (Item == nullptr) continue;
+
+		const bool bVisible = Item->WasRecentlyRendered(VisibilityTimeout);
+		Item->TickHover(DeltaTime, bVisible);
+		NumMovedLastUpdate += bVisible ? 1 : 0;
+	}
+
+	TickDescent(DeltaTime);
+
+	const double UpdateMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	AverageUpdateMs = FMath::Lerp(AverageUpdateMs, UpdateMs, 0.05);
+}
+
+TStatId UItemMotionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemMotionSubsystem, STATGROUP_Tickables);
+}
+
+bool UItemMotionSubsystem::IsTickable() const
+{
+	return HoveringItems.Num() > 0 || DescendingSouls.Num() > 0;
+}
+
+void UItemMotionSubsystem::ReportMotionCost() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Item motion: %d hovering items, %d moved last frame, %.4f ms average per frame (%.3f us per item)"),
+		HoveringItems.Num(),
+		NumMovedLastUpdate,
+		AverageUpdateMs,
+		HoveringItems.Num() > 0 ? AverageUpdateMs * 1000.0 / HoveringItems.Num() : 0.0
+	);
+}
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/PickupSubsystem.h"
+#include "Performance/SlashTrace.h"
+#include "Performance/SlashMemory.h"
+#include "Items/Item.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarUsePickupIndex(
+		TEXT("Slash.Pickups.UseIndex"),
+		true,
+		TEXT("Find the items the player can pick up with a grid index instead of an overlap sphere per item. Read when items begin play."),
+		ECVF_Default
+	);
+}
+
+bool UPickupSubsystem::IsIndexEnabled()
+{
+	return CVarUsePickupIndex.GetValueOnGameThread();
+}
+
+void UPickupSubsystem::RegisterPickup(AItem* Item, float Radius)
+{
+	LLM_SCOPE_BYTAG(Slash_Pickups);
+	if (Item == nullptr || Pickups.Contains(Item)) return;
+
+	const FIntPoint Cell = GetCell(Item->GetPickupLocation());
+	Cells.FindOrAdd(Cell).Add({ Item, Radius });
+	Pickups.Add(Item, Cell);
+	MaxPickupRadius = FMath::Max(MaxPickupRadius, Radius);
+	SLASH_TRACE_COUNTER_SET(SlashPickups, Pickups.Num());
+}
+
+void UPickupSubsystem::UnregisterPickup(AItem* Item)
+{
+	FIntPoint Cell;
+	if (!Pickups.RemoveAndCopyValue(Item, Cell)) return;
+	SLASH_TRACE_COUNTER_SET(SlashPickups, Pickups.Num());
+
+	if (TArray<FPickupEntry>* Entries = Cells.Find(Cell))
+	{
+		Entries->RemoveAllSwap([Item](const FPickupEntry& Entry) { return Entry.Item.Get() == Item; });
+		if (Entries->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UPickupSubsystem::QueryPickups(const FVector& SegmentStart, const FVector& SegmentEnd, float CapsuleRadius, TArray<AItem*>& OutItems) const
+{
+	const float Reach = CapsuleRadius + MaxPickupRadius;
+	const FIntPoint MinCell = GetCell(SegmentStart.ComponentMin(SegmentEnd) - FVector(Reach));
+	const FIntPoint MaxCell = GetCell(SegmentStart.ComponentMax(SegmentEnd) + FVector(Reach));
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const TArray<FPickupEntry>* Entries = Cells.Find(FIntPoint(X, Y));
+			if (Entries == nullptr) continue;
+
+			for (const FPickupEntry& Entry : *Entries)
+			{
+				AItem* Item = Entry.Item.Get();
+				if (Item == nullptr) continue;
+
+				const float Distance = FMath::PointDistToSegment(Item->GetPickupLocation(), SegmentStart, SegmentEnd);
+				if (Distance <= CapsuleRadius + Entry.Radius)
+				{
+					OutItems.Add(Item);
+				}
+			}
+		}
+	}
+}
+
+FIntPoint UPickupSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
@@ -3,37 +3,35 @@
 
 #include "Items/Soul.h"
 #include "Interfaces/PickupInterface.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "Items/ItemMotionSubsystem.h"
+#include "Components/SphereComponent.h"
 
 void ASoul::BeginPlay()
 {
 	Super::BeginPlay();
+	if (IsActorBeingDestroyed()) return;
 
-	const FVector Start = GetActorLocation();
-	const FVector End = Start - FVector{ 0.f, 0.f, 2000.f };
-
-	/** TEnumAsByte is just an enum in the form of an eight bit integer, an unsigned int. */
-	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
-	ObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery1);
-
-	TArray<AActor*> ActorsToIgnore;
-	ActorsToIgnore.Add(GetOwner()); // so the owner of this soul is ignore by the trace
-
-	FHitResult HitResult;
+	/** 
+	* Find the ground below us (ignoring the enemy that dropped this soul) and let the motion subsystem
+	*  take us down there. If there's no ground, we just stay where we are.
+	*/
+	UItemMotionSubsystem* ItemMotion = GetWorld()->GetSubsystem<UItemMotionSubsystem>();
+	double GroundZ = 0.;
+	if (ItemMotion && ItemMotion->FindGroundHeight(GetActorLocation(), GetOwner(), GroundZ))
+	{
+		DesiredZ = GroundZ + HeightAboveGround;
+		ItemMotion->StartDescent(this, DesiredZ, FMath::Abs(DriftRate), DescentCurve);
+	}
+}
 
-	UKismetSystemLibrary::LineTraceSingleForObjects(
-		this,
-		Start,
-		End,
-		ObjectTypes,
-		false,
-		ActorsToIgnore,
-		EDrawDebugTrace::None,
-		HitResult,
-		true
-	);
+void ASoul::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UItemMotionSubsystem* ItemMotion = GetWorld() ? GetWorld()->GetSubsystem<UItemMotionSubsystem>() : nullptr)
+	{
+		ItemMotion->StopDescent(this);
+	}
 
-	DesiredZ = HitResult.ImpactPoint.Z + 100.;
+	Super::EndPlay(EndPlayReason);
 }
 
 void ASoul::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -49,16 +47,22 @@ void ASoul::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Ot
 	}
 }
 
-void ASoul::Tick(float DeltaTime)
+void ASoul::StartHoming()
 {
-	Super::Tick(DeltaTime);
-
-	const double ZActorLocation = GetActorLocation().Z;
-
-	if (ZActorLocation > DesiredZ)
+	if (UItemMotionSubsystem* ItemMotion = GetWorld()->GetSubsystem<UItemMotionSubsystem>())
 	{
-		AddActorWorldOffset(
-			FVector{ 0., 0., DeltaTime * DriftRate }
-		);
+		ItemMotion->StopDescent(this);
 	}
+	StopHovering();
+	StopBeingPickup();
+	Sphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+int32 ASoul::CollectByMagnet()
+{
+	SpawnPickupSystem();
+	SpawnPickupSound();
+	Destroy();
+
+	return Souls;
 }
@@ -2,6 +2,9 @@
 
 
 #include "Items/Weapons/Weapon.h"
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashTrace.h"
+#include "Performance/SlashMemory.h"
 #include "Characters/SlashCharacter.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/SphereComponent.h"
@@ -10,12 +13,27 @@
 /** Use in OnBoxOverlap */
 #include "Kismet/KismetSystemLibrary.h"
 #include "Interfaces/HitInterface.h"
+#include "Components/HurtboxComponent.h"
+#include "Breakable/BreakableActor.h"
+
+/** Baked swings */
+#include "Combat/BladeTrajectoryAsset.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Engine/World.h"
 
 /** Deactivate the niagara system upon equip */
 #include "NiagaraComponent.h"
 
+DECLARE_CYCLE_STAT(TEXT("Weapon OnBoxOverlap"), STAT_SlashWeaponOnBoxOverlap, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Weapon BoxTrace"), STAT_SlashWeaponBoxTrace, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Weapon HurtboxTrace"), STAT_SlashWeaponHurtboxTrace, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Weapon ApplyHit"), STAT_SlashWeaponApplyHit, STATGROUP_Slash);
+DECLARE_CYCLE_STAT(TEXT("Weapon Baked Swing"), STAT_SlashWeaponBakedSwing, STATGROUP_Slash);
+
 AWeapon::AWeapon()
 {
+   LLM_SCOPE_BYTAG(Slash_Weapons);
    // Create the WeaponBox
    WeaponBox = CreateDefaultSubobject<UBoxComponent>(TEXT("Weapon Box"));
    WeaponBox->SetupAttachment(GetRootComponent());
@@ -35,15 +53,28 @@ AWeapon::AWeapon()
 
 void AWeapon::BeginPlay()
 {
+   LLM_SCOPE_BYTAG(Slash_Weapons);
    Super::BeginPlay();
 
    // Bind the callback function to the delegate
    WeaponBox->OnComponentBeginOverlap.AddDynamic(this, &AWeapon::OnBoxOverlap);
 }
 
+void AWeapon::Tick(float DeltaTime)
+{
+   LLM_SCOPE_BYTAG(Slash_Weapons);
+   Super::Tick(DeltaTime);
+
+   if (ActiveTrajectories)
+   {
+      UpdateBakedSwing();
+   }
+}
+
 void AWeapon::Equip(USceneComponent* InParent, FName InSocketName, AActor* NewOwner, APawn* NewInstigator)
 {
    ItemState = EItemState::EIS_Equipped;
+   StopHovering();
 
    /** Set the owner and instigator here. That way the actor won't have to worry about it. */
    SetOwner(NewOwner);
@@ -69,6 +100,7 @@ void AWeapon::DisableSphereCollision()
    {
       Sphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
    }
+   StopBeingPickup();
 }
 
 void AWeapon::PlayEquipSound()
@@ -91,14 +123,23 @@ void AWeapon::AttachMeshToSocket(USceneComponent* InParent, const FName& InSocke
 
 void AWeapon::OnBoxOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+   LLM_SCOPE_BYTAG(Slash_Weapons);
+   SLASH_SCOPE(SPB_Combat, WeaponOnBoxOverlap);
    /** 
    * Enemies ignore each other. This can also be more generic if we want not only Enemies to "know" each other,
    *  and in that case we use the same concept of Keys in print string node or debug message.
    */
    if (ActorIsSameType(OtherActor)) return;
 
+   /** While a baked swing is running, characters with hurtboxes are hit from UpdateBakedSwing() instead */
+   if (ActiveTrajectories && HasHurtboxes(OtherActor)) return;
+
    FHitResult BoxHit;
-   BoxTrace(BoxHit);
+   float DamageMultiplier = 1.f;
+   if (!HurtboxTrace(OtherActor, BoxHit, DamageMultiplier))
+   {
+      BoxTrace(BoxHit);
+   }
 
    if (BoxHit.GetActor())
    {
@@ -119,20 +160,34 @@ void AWeapon::OnBoxOverlap(UPrimitiveComponent* OverlappedComponent, AActor* Oth
 
       if (ActorIsSameType(BoxHit.GetActor())) return;
 
-      /**
-      * We need the damage to be applied before we play the montage, so that when it calls Execute_GetHit,
-      *  and there it calls the montage to play, it'll play either the hit or death montage (by checking if the
-      *  enemy still has health).
-      */
-      UGameplayStatics::ApplyDamage(
-         BoxHit.GetActor(),
-         Damage,
-         GetInstigator()->GetController(),
-         this,
-         UDamageType::StaticClass()
-      );
+      ApplyHit(BoxHit, DamageMultiplier);
+   }
+}
+
+void AWeapon::ApplyHit(FHitResult& BoxHit, float DamageMultiplier)
+{
+   SLASH_SCOPE(SPB_Combat, WeaponApplyHit);
+   SLASH_PERF_DAMAGE_EVENT();
+   SLASH_TRACE_BOOKMARK(TEXT("Hit %s -> %s"), *GetNameSafe(GetOwner()), *GetNameSafe(BoxHit.GetActor()));
+   /**
+   * We need the damage to be applied before we play the montage, so that when it calls Execute_GetHit,
+   *  and there it calls the montage to play, it'll play either the hit or death montage (by checking if the
+   *  enemy still has health).
+   */
+   UGameplayStatics::ApplyDamage(
+      BoxHit.GetActor(),
+      Damage * DamageMultiplier,
+      GetInstigator()->GetController(),
+      this,
+      UDamageType::StaticClass()
+   );
 
-      ExecuteGetHit(BoxHit);
+   ExecuteGetHit(BoxHit);
+
+   /** A breakable playing back a recorded fracture doesn't need our fields (and a live simulation) to break */
+   const ABreakableActor* Breakable = Cast<ABreakableActor>(BoxHit.GetActor());
+   if (Breakable == nullptr || !Breakable->IsPlayingCachedFracture())
+   {
       CreateFields(BoxHit.ImpactPoint);
    }
 }
@@ -161,6 +216,7 @@ void AWeapon::ExecuteGetHit(FHitResult& BoxHit)
 
 void AWeapon::BoxTrace(FHitResult& BoxHit)
 {
+   SLASH_SCOPE(SPB_Combat, WeaponBoxTrace);
    const FVector Start = TraceStart->GetComponentLocation();
    const FVector End = TraceEnd->GetComponentLocation();
 
@@ -177,6 +233,7 @@ void AWeapon::BoxTrace(FHitResult& BoxHit)
       ActorsToIgnore.AddUnique(Actor);
    }
 
+   INC_DWORD_STAT(STAT_SlashTraces);
    UKismetSystemLibrary::BoxTraceSingle(
       this,
       Start,
@@ -193,3 +250,148 @@ void AWeapon::BoxTrace(FHitResult& BoxHit)
 
    IgnoreActors.AddUnique(BoxHit.GetActor());
 }
+
+bool AWeapon::HasHurtboxes(AActor* OtherActor) const
+{
+   const UHurtboxComponent* Hurtboxes = OtherActor ? OtherActor->FindComponentByClass<UHurtboxComponent>() : nullptr;
+   return Hurtboxes && Hurtboxes->HasCapsules();
+}
+
+bool AWeapon::HurtboxTrace(AActor* OtherActor, FHitResult& BoxHit, float& OutDamageMultiplier)
+{
+   SLASH_SCOPE(SPB_Combat, WeaponHurtboxTrace);
+   if (OtherActor == GetOwner() || !HasHurtboxes(OtherActor)) return false;
+
+   UHurtboxComponent* Hurtboxes = OtherActor->FindComponentByClass<UHurtboxComponent>();
+
+   // Already hit during this swing, same as BoxTrace ignoring it
+   if (IgnoreActors.Contains(OtherActor)) return true;
+
+   /** 
+   * The box trace sweeps a box of BoxTraceExtent along the blade, so we sweep a sphere that encloses it (its radius
+   *  is the half-diagonal of the box).
+   */
+   const FVector Start = TraceStart->GetComponentLocation();
+   const FVector End = TraceEnd->GetComponentLocation();
+
+   FHurtboxHit HurtboxHit;
+   INC_DWORD_STAT(STAT_SlashTraces);
+   if (Hurtboxes->SweepSegment(Start, End, BoxTraceExtent.Size(), HurtboxHit))
+   {
+      BoxHit = FHitResult(OtherActor, nullptr, HurtboxHit.ImpactPoint, HurtboxHit.ImpactNormal);
+      OutDamageMultiplier = HurtboxHit.DamageMultiplier;
+      IgnoreActors.AddUnique(OtherActor);
+   }
+
+   return true;
+}
+
+void AWeapon::BeginBakedSwing(UBladeTrajectoryAsset* Trajectories, USkeletalMeshComponent* InWielderMesh)
+{
+   UAnimInstance* AnimInstance = InWielderMesh ? InWielderMesh->GetAnimInstance() : nullptr;
+   if (Trajectories == nullptr || AnimInstance == nullptr || !AnimInstance->Montage_IsPlaying(Trajectories->GetMontage())) return;
+
+   ActiveTrajectories = Trajectories;
+   WielderMesh = InWielderMesh;
+   ActiveSection = nullptr;
+
+   /** 
+   * Gather who can be hit during this swing once, with a single overlap query around our owner, instead of
+   *  relying on the weapon box overlapping the meshes every frame.
+   */
+   SwingCandidates.Reset();
+   TArray<FOverlapResult> Overlaps;
+   FCollisionQueryParams QueryParams;
+   QueryParams.AddIgnoredActor(GetOwner());
+   INC_DWORD_STAT(STAT_SlashTraces);
+   GetWorld()->OverlapMultiByObjectType(
+      Overlaps,
+      WielderMesh->GetComponentLocation(),
+      FQuat::Identity,
+      FCollisionObjectQueryParams(ECollisionChannel::ECC_Pawn),
+      FCollisionShape::MakeSphere(SwingCandidateRadius),
+      QueryParams
+   );
+
+   for (const FOverlapResult& Overlap : Overlaps)
+   {
+      AActor* Candidate = Overlap.GetActor();
+      if (Candidate && !ActorIsSameType(Candidate) && HasHurtboxes(Candidate))
+      {
+         SwingCandidates.AddUnique(Candidate->FindComponentByClass<UHurtboxComponent>());
+      }
+   }
+
+   SetActorTickEnabled(true);
+}
+
+void AWeapon::EndBakedSwing()
+{
+   ActiveTrajectories = nullptr;
+   WielderMesh = nullptr;
+   ActiveSection = nullptr;
+   SwingCandidates.Reset();
+
+   // Weapons only need to tick while a baked swing is running
+   SetActorTickEnabled(false);
+}
+
+void AWeapon::UpdateBakedSwing()
+{
+   SLASH_SCOPE(SPB_Combat, WeaponBakedSwing);
+   UAnimMontage* Montage = ActiveTrajectories->GetMontage();
+   UAnimInstance* AnimInstance = WielderMesh ? WielderMesh->GetAnimInstance() : nullptr;
+   if (AnimInstance == nullptr || !AnimInstance->Montage_IsPlaying(Montage))
+   {
+      EndBakedSwing();
+      return;
+   }
+
+   const float Position = AnimInstance->Montage_GetPosition(Montage);
+   const FName SectionName = AnimInstance->Montage_GetCurrentSection(Montage);
+   if (ActiveSection == nullptr || ActiveSection->SectionName != SectionName)
+   {
+      ActiveSection = ActiveTrajectories->FindSection(SectionName);
+      // Also test the sample we're at right now on the first update
+      LastSwingPosition = Position - KINDA_SMALL_NUMBER;
+   }
+   if (ActiveSection == nullptr || ActiveSection->NumSamples() == 0) return;
+
+   /** 
+   * Test every baked sample between the previous montage position and the current one. A low frame rate just
+   *  tests more samples this frame, so hits are the same no matter the frame rate.
+   */
+   const float Interval = ActiveSection->SampleInterval;
+   const int32 FirstSample = FMath::Max(FMath::FloorToInt((LastSwingPosition - ActiveSection->StartTime) / Interval) + 1, 0);
+   const int32 LastSample = FMath::Min(FMath::FloorToInt((Position - ActiveSection->StartTime) / Interval), ActiveSection->NumSamples() - 1);
+   LastSwingPosition = Position;
+
+   const FTransform MeshTransform = WielderMesh->GetComponentTransform();
+   // Encloses the BoxTraceExtent box, same as HurtboxTrace
+   const float SweepRadius = BoxTraceExtent.Size();
+
+   for (int32 Sample = FirstSample; Sample <= LastSample; ++Sample)
+   {
+      const FVector Start = MeshTransform.TransformPosition(FVector(ActiveSection->BladeStart[Sample]));
+      const FVector End = MeshTransform.TransformPosition(FVector(ActiveSection->BladeEnd[Sample]));
+
+      for (const TWeakObjectPtr<UHurtboxComponent>& Candidate : SwingCandidates)
+      {
+         AActor* CandidateActor = Candidate.IsValid() ? Candidate->GetOwner() : nullptr;
+         if (CandidateActor == nullptr || IgnoreActors.Contains(CandidateActor)) continue;
+
+         FHurtboxHit HurtboxHit;
+         INC_DWORD_STAT(STAT_SlashTraces);
+         if (Candidate->SweepSegment(Start, End, SweepRadius, HurtboxHit))
+         {
+            IgnoreActors.AddUnique(CandidateActor);
+
+            FHitResult BoxHit(CandidateActor, nullptr, HurtboxHit.ImpactPoint, HurtboxHit.ImpactNormal);
+            ApplyHit(BoxHit, HurtboxHit.DamageMultiplier);
+
+            // Getting hit can end our own swing (e.g. the hit killed us or disabled our collision)
+            if (ActiveTrajectories == nullptr) return;
+         }
+      }
+   }
+}
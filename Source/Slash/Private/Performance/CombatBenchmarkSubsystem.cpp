@@ -0,0 +1,316 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/CombatBenchmarkSubsystem.h"
+#include "Performance/CombatHarness.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+
+/** Report */
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformMemory.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatBenchmark, Log, All);
+
+bool UCombatBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("SlashBenchmark"));
+}
+
+bool UCombatBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FParse::Value(FCommandLine::Get(), TEXT("BenchmarkEnemies="), NumEnemies);
+	FParse::Value(FCommandLine::Get(), TEXT("BenchmarkSeconds="), DurationSeconds);
+	if (!FParse::Value(FCommandLine::Get(), TEXT("BenchmarkOutput="), OutputPath))
+	{
+		OutputPath = FPaths::ProfilingDir() / TEXT("SlashBenchmark") / FString::Printf(TEXT("CombatBenchmark_%d.json"), NumEnemies);
+	}
+	bBudgetRequested = FParse::Value(FCommandLine::Get(), TEXT("BenchmarkBudget="), BudgetPath);
+	if (!bBudgetRequested)
+	{
+		BudgetPath = FPaths::ProjectDir() / BudgetFile;
+	}
+	bCaptureCsv = FParse::Param(FCommandLine::Get(), TEXT("BenchmarkCsv"));
+
+	Harness = NewObject<UCombatHarness>(this);
+	if (!Harness->LoadClasses())
+	{
+		FPlatformMisc::RequestExitWithStatus(false, 1);
+		return;
+	}
+
+	/** A typo on the command line must not give a report that looks valid */
+	if (NumEnemies < 1 || DurationSeconds <= 0.f || FixedFrameRate <= 0.f || WarmupFrames < 0 || MemorySampleInterval < 1)
+	{
+		UE_LOG(LogCombatBenchmark, Error, TEXT("Invalid settings: %d enemies (at least 1), %.2f seconds and %.2f fps (more than 0), %d warmup frames (0 or more), memory sampled every %d frames (at least 1)"),
+			NumEnemies, DurationSeconds, FixedFrameRate, WarmupFrames, MemorySampleInterval);
+		FPlatformMisc::RequestExitWithStatus(false, 1);
+		return;
+	}
+
+	/** Same random numbers and same time steps on every run, whatever the machine */
+	FMath::RandInit(0);
+	FMath::SRandInit(0);
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FixedFrameRate);
+
+	if (TActorIterator<APlayerStart> PlayerStart(&InWorld); PlayerStart)
+	{
+		Harness->SetOrigin(PlayerStart->GetActorLocation());
+	}
+
+	SpawnEnemies();
+	// Nothing to drive yet, this spawns the stand-in
+	Harness->DriveStandIn(&InWorld, StandInAttackRange);
+
+#if CSV_PROFILER
+	// Otherwise started by Tick() once the warmup is over
+	if (WarmupFrames == 0 && bCaptureCsv)
+	{
+		FCsvProfiler::Get()->BeginCapture();
+	}
+#endif
+
+	LastFrameTime = FPlatformTime::Seconds();
+	bRunning = true;
+	UE_LOG(LogCombatBenchmark, Display, TEXT("Combat benchmark: %d enemies, %.0f seconds at %.0f fps"), NumEnemies, DurationSeconds, FixedFrameRate);
+}
+
+void UCombatBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	++NumFrames;
+
+	// Dead enemies are replaced once their corpse is gone, so there are always NumEnemies of them
+	SpawnEnemies();
+	Harness->DriveStandIn(GetWorld(), StandInAttackRange);
+
+	if (NumFrames > WarmupFrames)
+	{
+		RecordFrame();
+	}
+#if CSV_PROFILER
+	else if (NumFrames == WarmupFrames && bCaptureCsv)
+	{
+		FCsvProfiler::Get()->BeginCapture();
+	}
+#endif
+	LastFrameTime = FPlatformTime::Seconds();
+
+	if (NumFrames >= WarmupFrames + FMath::CeilToInt(DurationSeconds * FixedFrameRate))
+	{
+		Finish();
+	}
+}
+
+void UCombatBenchmarkSubsystem::SpawnEnemies()
+{
+	/** Rings of 16 enemies around the stand-in, facing it */
+	Harness->SpawnEnemies(GetWorld(), NumEnemies, SpawnRadius, 16, 200.f);
+}
+
+TStatId UCombatBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+bool UCombatBenchmarkSubsystem::IsTickable() const
+{
+	return bRunning;
+}
+
+void UCombatBenchmarkSubsystem::RecordFrame()
+{
+	++NumRecordedFrames;
+
+	/** Wall time of the whole frame, the fixed timestep only fakes the game time */
+	FrameMs.Add(static_cast<float>((FPlatformTime::Seconds() - LastFrameTime) * 1000.0));
+	GameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+
+	const FSlashPerfCounters& Counters = FSlashPerfCounters::Get();
+	for (int32 Bucket = 0; Bucket < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Bucket)
+	{
+		BucketTotalMs[Bucket] += Counters.GetBucketMsLastFrame(static_cast<ESlashPerfBucket>(Bucket));
+	}
+	TotalDamageEvents += Counters.GetDamageEventsLastFrame();
+
+	if ((NumRecordedFrames - 1) % MemorySampleInterval == 0)
+	{
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+		PeakUsedPhysical = FMath::Max3<uint64>(PeakUsedPhysical, MemoryStats.UsedPhysical, MemoryStats.PeakUsedPhysical);
+		PeakUsedVirtual = FMath::Max3<uint64>(PeakUsedVirtual, MemoryStats.UsedVirtual, MemoryStats.PeakUsedVirtual);
+	}
+}
+
+void UCombatBenchmarkSubsystem::Finish()
+{
+	bRunning = false;
+
+#if CSV_PROFILER
+	if (bCaptureCsv)
+	{
+		FCsvProfiler::Get()->EndCapture();
+	}
+#endif
+
+	TArray<FString> BudgetFailures;
+	bool bBudgetChecked = false;
+	const bool bBudgetUsable = CheckBudgets(BudgetFailures, bBudgetChecked);
+
+	const bool bWritten = WriteReport(OutputPath, BudgetFailures, bBudgetChecked);
+	if (bWritten)
+	{
+		UE_LOG(LogCombatBenchmark, Display, TEXT("Combat benchmark report written to %s"), *OutputPath);
+	}
+	else
+	{
+		UE_LOG(LogCombatBenchmark, Error, TEXT("Could not write the combat benchmark report to %s"), *OutputPath);
+	}
+
+	int32 ExitCode = 0;
+	if (!bWritten)
+	{
+		ExitCode = 1;
+	}
+	else if (!bBudgetUsable)
+	{
+		ExitCode = 3;
+	}
+	else if (BudgetFailures.Num() > 0)
+	{
+		ExitCode = 2;
+	}
+	FPlatformMisc::RequestExitWithStatus(false, ExitCode);
+}
+
+bool UCombatBenchmarkSubsystem::CheckBudgets(TArray<FString>& OutFailures, bool& bOutChecked) const
+{
+	bOutChecked = false;
+
+#if !SLASH_PERF_COUNTERS
+	// Every bucket would read 0 ms and pass
+	UE_LOG(LogCombatBenchmark, Error, TEXT("No budget checked: the perf counters are compiled out of this build"));
+	return false;
+#endif
+
+	FString BudgetJson;
+	TSharedPtr<FJsonObject> Budget;
+	if (!FFileHelper::LoadFileToString(BudgetJson, *BudgetPath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BudgetJson), Budget) || !Budget.IsValid())
+	{
+		UE_LOG(LogCombatBenchmark, Error, TEXT("No budget checked: could not read %s"), *BudgetPath);
+		return false;
+	}
+
+	/** Budgets are only meaningful for the scenario they were measured on */
+	int32 BudgetEnemies = 0;
+	if (Budget->TryGetNumberField(TEXT("NumEnemies"), BudgetEnemies) && BudgetEnemies != NumEnemies)
+	{
+		if (bBudgetRequested)
+		{
+			UE_LOG(LogCombatBenchmark, Error, TEXT("No budget checked: %s is for %d enemies, this run had %d"), *BudgetPath, BudgetEnemies, NumEnemies);
+			return false;
+		}
+		UE_LOG(LogCombatBenchmark, Display, TEXT("No budget checked: the default budget %s is for %d enemies, this run had %d"), *BudgetPath, BudgetEnemies, NumEnemies);
+		return true;
+	}
+
+	double ThresholdPercent = 10.0;
+	Budget->TryGetNumberField(TEXT("ThresholdPercent"), ThresholdPercent);
+
+	const TSharedPtr<FJsonObject>* AverageMs = nullptr;
+	if (!Budget->TryGetObjectField(TEXT("AverageMs"), AverageMs))
+	{
+		UE_LOG(LogCombatBenchmark, Error, TEXT("No budget checked: %s has no AverageMs"), *BudgetPath);
+		return false;
+	}
+
+	bOutChecked = true;
+
+	UE_LOG(LogCombatBenchmark, Display, TEXT("Budgets (%s, %.0f%% threshold):"), *BudgetPath, ThresholdPercent);
+	for (int32 Bucket = 0; Bucket < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Bucket)
+	{
+		const TCHAR* Name = FSlashPerfCounters::GetBucketName(static_cast<ESlashPerfBucket>(Bucket));
+		double BudgetMs = 0.0;
+		if (!(*AverageMs)->TryGetNumberField(Name, BudgetMs)) continue;
+
+		const double Ms = NumRecordedFrames > 0 ? BucketTotalMs[Bucket] / NumRecordedFrames : 0.0;
+		const double OverPercent = BudgetMs > 0.0 ? (Ms / BudgetMs - 1.0) * 100.0 : 0.0;
+		const FString Line = FString::Printf(TEXT("%-10s %7.3f ms average, budget %7.3f ms (%+.0f%%)"), Name, Ms, BudgetMs, OverPercent);
+
+		if (OverPercent > ThresholdPercent)
+		{
+			UE_LOG(LogCombatBenchmark, Error, TEXT("  %s OVER BUDGET"), *Line);
+			OutFailures.Add(Line);
+		}
+		else
+		{
+			UE_LOG(LogCombatBenchmark, Display, TEXT("  %s"), *Line);
+		}
+	}
+
+	if (OutFailures.Num() > 0)
+	{
+		UE_LOG(LogCombatBenchmark, Error, TEXT("%d categories over budget"), OutFailures.Num());
+	}
+	return true;
+}
+
+bool UCombatBenchmarkSubsystem::WriteReport(const FString& Path, const TArray<FString>& BudgetFailures, bool bBudgetChecked) const
+{
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Map"), GetWorld()->GetMapName());
+	Report->SetStringField(TEXT("BuildVersion"), FApp::GetBuildVersion());
+	Report->SetNumberField(TEXT("NumEnemies"), NumEnemies);
+	Report->SetNumberField(TEXT("DurationSeconds"), DurationSeconds);
+	Report->SetNumberField(TEXT("FixedFrameRate"), FixedFrameRate);
+	Report->SetNumberField(TEXT("RecordedFrames"), NumRecordedFrames);
+	Report->SetNumberField(TEXT("StandInDeaths"), Harness->GetNumStandInDeaths());
+	Report->SetNumberField(TEXT("DamageEvents"), static_cast<double>(TotalDamageEvents));
+
+	Report->SetObjectField(TEXT("FrameMs"), UCombatHarness::MakeDistribution(FrameMs));
+	Report->SetObjectField(TEXT("GameThreadMs"), UCombatHarness::MakeDistribution(GameThreadMs));
+
+	/** Same buckets as the perf overlay and "stat Slash" */
+	TSharedRef<FJsonObject> Buckets = MakeShared<FJsonObject>();
+	for (int32 Bucket = 0; Bucket < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Bucket)
+	{
+		TSharedRef<FJsonObject> BucketTimes = MakeShared<FJsonObject>();
+		BucketTimes->SetNumberField(TEXT("TotalMs"), BucketTotalMs[Bucket]);
+		BucketTimes->SetNumberField(TEXT("AverageMs"), NumRecordedFrames > 0 ? BucketTotalMs[Bucket] / NumRecordedFrames : 0.0);
+		Buckets->SetObjectField(FSlashPerfCounters::GetBucketName(static_cast<ESlashPerfBucket>(Bucket)), BucketTimes);
+	}
+	Report->SetObjectField(TEXT("Subsystems"), Buckets);
+
+	TSharedRef<FJsonObject> Memory = MakeShared<FJsonObject>();
+	Memory->SetNumberField(TEXT("PeakUsedPhysicalMB"), PeakUsedPhysical / (1024.0 * 1024.0));
+	Memory->SetNumberField(TEXT("PeakUsedVirtualMB"), PeakUsedVirtual / (1024.0 * 1024.0));
+	Report->SetObjectField(TEXT("Memory"), Memory);
+
+	TArray<TSharedPtr<FJsonValue>> Failures;
+	for (const FString& Failure : BudgetFailures)
+	{
+		Failures.Add(MakeShared<FJsonValueString>(Failure));
+	}
+	Report->SetBoolField(TEXT("BudgetChecked"), bBudgetChecked);
+	Report->SetArrayField(TEXT("BudgetFailures"), Failures);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if (!FJsonSerializer::Serialize(Report, Writer)) return false;
+
+	return FFileHelper::SaveStringToFile(Json, *Path);
+}
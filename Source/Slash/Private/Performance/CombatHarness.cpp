@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/CombatHarness.h"
+#include "Performance/SlashMemory.h"
+#include "Enemy/Enemy.h"
+#include "Characters/SlashCharacter.h"
+#include "Items/Weapons/Weapon.h"
+#include "AIController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Dom/JsonObject.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCombatHarness, Log, All);
+
+namespace
+{
+	/** Value below which Percentile percent of the sorted samples are */
+	double GetPercentile(const TArray<float>& SortedSamples, double Percentile)
+	{
+		if (SortedSamples.Num() == 0) return 0.0;
+
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile / 100.0 * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+		return SortedSamples[Index];
+	}
+}
+
+bool UCombatHarness::LoadClasses()
+{
+	if (EnemyClasses.Num() == 0 || StandInClass.IsNull())
+	{
+		UE_LOG(LogCombatHarness, Error, TEXT("EnemyClasses and StandInClass must be set in [/Script/Slash.CombatHarness]"));
+		return false;
+	}
+
+	for (const TSoftClassPtr<AEnemy>& EnemyClass : EnemyClasses)
+	{
+		if (EnemyClass.LoadSynchronous() == nullptr)
+		{
+			UE_LOG(LogCombatHarness, Error, TEXT("Could not load %s"), *EnemyClass.ToString());
+			return false;
+		}
+	}
+	if (StandInClass.LoadSynchronous() == nullptr)
+	{
+		UE_LOG(LogCombatHarness, Error, TEXT("Could not load %s"), *StandInClass.ToString());
+		return false;
+	}
+
+	// Optional, the stand-in fights unarmed without it
+	StandInWeaponClass.LoadSynchronous();
+	return true;
+}
+
+void UCombatHarness::SpawnEnemies(UWorld* World, int32 NumEnemies, float Radius, int32 EnemiesPerRing, float RingSpacing)
+{
+	Enemies.SetNum(NumEnemies);
+	for (int32 Index = 0; Index < NumEnemies; ++Index)
+	{
+		if (IsValid(Enemies[Index])) continue;
+
+		UClass* EnemyClass = EnemyClasses[Index % EnemyClasses.Num()].Get();
+		if (EnemyClass == nullptr) continue;
+
+		const float Angle = 2.f * PI * (Index % EnemiesPerRing) / EnemiesPerRing;
+		const float RingRadius = Radius + RingSpacing * (Index / EnemiesPerRing);
+		const FVector Offset(FMath::Cos(Angle) * RingRadius, FMath::Sin(Angle) * RingRadius, 0.f);
+		const FTransform Transform((-Offset).Rotation(), Origin + Offset);
+
+		// Spawned pawns only get an AI controller if they ask for it before BeginPlay
+		LLM_SCOPE_BYTAG(Slash_Enemies);
+		AEnemy* Enemy = World->SpawnActorDeferred<AEnemy>(EnemyClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (Enemy)
+		{
+			Enemy->AutoPossessAI = EAutoPossessAI::Spawned;
+			UGameplayStatics::FinishSpawningActor(Enemy, Transform);
+			++NumEnemiesSpawned;
+		}
+		Enemies[Index] = Enemy;
+	}
+}
+
+void UCombatHarness::SpawnStandIn(UWorld* World)
+{
+	UClass* Class = StandInClass.Get();
+	if (Class == nullptr) return;
+
+	const FTransform Transform(Origin);
+	StandIn = World->SpawnActorDeferred<ASlashCharacter>(Class, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (StandIn == nullptr) return;
+
+	StandIn->AutoPossessAI = EAutoPossessAI::Spawned;
+	UGameplayStatics::FinishSpawningActor(StandIn, Transform);
+
+	if (UClass* WeaponClass = StandInWeaponClass.Get())
+	{
+		StandIn->EquipWeapon(World->SpawnActor<AWeapon>(WeaponClass, Transform));
+	}
+}
+
+AEnemy* UCombatHarness::FindClosestEnemy(const FVector& Location) const
+{
+	AEnemy* Closest = nullptr;
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (!IsValid(Enemy) || Enemy->IsDead()) continue;
+
+		const double DistanceSquared = FVector::DistSquared(Enemy->GetActorLocation(), Location);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			Closest = Enemy;
+		}
+	}
+	return Closest;
+}
+
+void UCombatHarness::DriveStandIn(UWorld* World, float AttackRange)
+{
+	if (!IsValid(StandIn) || StandIn->GetActionState() == EActionState::EAS_Dead)
+	{
+		if (StandIn)
+		{
+			++NumStandInDeaths;
+			StandIn->SetLifeSpan(5.f);
+			StandIn = nullptr;
+		}
+		SpawnStandIn(World);
+		return;
+	}
+
+	AEnemy* Target = FindClosestEnemy(StandIn->GetActorLocation());
+	if (Target == nullptr) return;
+
+	const FVector ToTarget = Target->GetActorLocation() - StandIn->GetActorLocation();
+	AAIController* Controller = Cast<AAIController>(StandIn->GetController());
+	if (Controller && AttackRange > 0.f)
+	{
+		if (ToTarget.SizeSquared2D() > FMath::Square(AttackRange))
+		{
+			// Asking again every frame would restart the path each time
+			if (Controller->GetMoveStatus() == EPathFollowingStatus::Idle || Controller->GetPathFollowingComponent()->GetMoveGoal() != Target)
+			{
+				Controller->MoveToActor(Target, AttackRange * 0.5f);
+			}
+			return;
+		}
+		Controller->StopMovement();
+	}
+
+	StandIn->SetActorRotation(FRotator(0.f, ToTarget.Rotation().Yaw, 0.f));
+	StandIn->LeftButtonAttack();
+}
+
+void UCombatHarness::Reset()
+{
+	Enemies.Reset();
+	StandIn = nullptr;
+}
+
+TSharedRef<FJsonObject> UCombatHarness::MakeDistribution(TArray<float> Samples)
+{
+	Samples.Sort();
+
+	double Sum = 0.0;
+	for (const float Sample : Samples)
+	{
+		Sum += Sample;
+	}
+
+	TSharedRef<FJsonObject> Distribution = MakeShared<FJsonObject>();
+	Distribution->SetNumberField(TEXT("Average"), Samples.Num() > 0 ? Sum / Samples.Num() : 0.0);
+	Distribution->SetNumberField(TEXT("P50"), GetPercentile(Samples, 50.0));
+	Distribution->SetNumberField(TEXT("P90"), GetPercentile(Samples, 90.0));
+	Distribution->SetNumberField(TEXT("P95"), GetPercentile(Samples, 95.0));
+	Distribution->SetNumberField(TEXT("P99"), GetPercentile(Samples, 99.0));
+	Distribution->SetNumberField(TEXT("Max"), Samples.Num() > 0 ? Samples.Last() : 0.0);
+	return Distribution;
+}
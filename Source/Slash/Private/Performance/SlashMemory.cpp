@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/SlashMemory.h"
+#include "Enemy/Enemy.h"
+#include "Items/Item.h"
+#include "HAL/IConsoleManager.h"
+#include "EngineUtils.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectHash.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSlashMemory, Log, All);
+
+LLM_DEFINE_TAG(Slash);
+LLM_DEFINE_TAG(Slash_Enemies, TEXT("Enemies"), TEXT("Slash"));
+LLM_DEFINE_TAG(Slash_Weapons, TEXT("Weapons"), TEXT("Slash"));
+LLM_DEFINE_TAG(Slash_Pickups, TEXT("Pickups"), TEXT("Slash"));
+LLM_DEFINE_TAG(Slash_Breakables, TEXT("Breakables"), TEXT("Slash"));
+LLM_DEFINE_TAG(Slash_HUD, TEXT("HUD"), TEXT("Slash"));
+
+namespace
+{
+	struct FArchetypeMemory
+	{
+		int32 NumActors = 0;
+		SIZE_T ObjectBytes = 0;
+		SIZE_T ResourceBytes = 0;
+	};
+
+	/**
+	* Memory of the actor and everything it owns (components, widgets, perception...): the UObjects themselves, as
+	*  "obj list" counts them, plus the resources they report (mesh instances, render data...).
+	*/
+	void CountActorMemory(AActor* Actor, FArchetypeMemory& Memory)
+	{
+		TArray<UObject*> Objects;
+		GetObjectsWithOuter(Actor, Objects, true);
+		Objects.Add(Actor);
+
+		for (UObject* Object : Objects)
+		{
+			FArchiveCountMem CountMem(Object);
+			Memory.ObjectBytes += CountMem.GetMax();
+			Memory.ResourceBytes += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+		++Memory.NumActors;
+	}
+
+	template<typename ActorType>
+	void ReportArchetypes(UWorld* World, const TCHAR* Title)
+	{
+		TMap<UClass*, FArchetypeMemory> Archetypes;
+		for (TActorIterator<ActorType> It(World); It; ++It)
+		{
+			CountActorMemory(*It, Archetypes.FindOrAdd(It->GetClass()));
+		}
+
+		Archetypes.ValueSort([](const FArchetypeMemory& A, const FArchetypeMemory& B)
+		{
+			return A.ObjectBytes + A.ResourceBytes > B.ObjectBytes + B.ResourceBytes;
+		});
+
+		UE_LOG(LogSlashMemory, Display, TEXT("%s:"), Title);
+		for (const TPair<UClass*, FArchetypeMemory>& Archetype : Archetypes)
+		{
+			const FArchetypeMemory& Memory = Archetype.Value;
+			UE_LOG(LogSlashMemory, Display, TEXT("  %-40s %5d actors %10.1f KB total %10llu bytes each (%llu objects + %llu resources)"),
+				*Archetype.Key->GetName(),
+				Memory.NumActors,
+				(Memory.ObjectBytes + Memory.ResourceBytes) / 1024.0,
+				static_cast<uint64>((Memory.ObjectBytes + Memory.ResourceBytes) / Memory.NumActors),
+				static_cast<uint64>(Memory.ObjectBytes / Memory.NumActors),
+				static_cast<uint64>(Memory.ResourceBytes / Memory.NumActors)
+			);
+		}
+	}
+
+	void ReportSlashMemory(UWorld* World)
+	{
+		if (World == nullptr) return;
+
+		ReportArchetypes<AEnemy>(World, TEXT("Enemies"));
+		ReportArchetypes<AItem>(World, TEXT("Items"));
+	}
+
+	FAutoConsoleCommandWithWorld SlashMemReportCommand(
+		TEXT("Slash.MemReport"),
+		TEXT("Print the memory of every AEnemy and AItem class in the world: number of actors, total and bytes per actor (components included)"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&ReportSlashMemory)
+	);
+}
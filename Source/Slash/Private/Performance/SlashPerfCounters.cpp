@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/SlashPerfCounters.h"
+#include "Performance/SlashStats.h"
+#include "Misc/CoreDelegates.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_STAT(STAT_SlashTraces);
+DEFINE_STAT(STAT_SlashSpawns);
+DEFINE_STAT(STAT_SlashDamageEvents);
+
+/** One CSV category per bucket, each with the bucket's game thread time as GameThreadMs */
+CSV_DEFINE_CATEGORY(SlashAI, true);
+CSV_DEFINE_CATEGORY(SlashCombat, true);
+CSV_DEFINE_CATEGORY(SlashPickups, true);
+CSV_DEFINE_CATEGORY(SlashItems, true);
+CSV_DEFINE_CATEGORY(SlashHUD, true);
+CSV_DEFINE_CATEGORY(SlashFX, true);
+CSV_DEFINE_CATEGORY(SlashDebris, true);
+CSV_DEFINE_CATEGORY(SlashAnimation, true);
+
+FSlashPerfCounters& FSlashPerfCounters::Get()
+{
+	static FSlashPerfCounters Counters;
+	return Counters;
+}
+
+FSlashPerfCounters::FSlashPerfCounters()
+{
+	FCoreDelegates::OnEndFrame.AddRaw(this, &FSlashPerfCounters::EndFrame);
+}
+
+void FSlashPerfCounters::EndFrame()
+{
+#if CSV_PROFILER
+	if (FCsvProfiler::Get()->IsCapturing())
+	{
+		static const int32 CsvCategories[] =
+		{
+			CSV_CATEGORY_INDEX(SlashAI),
+			CSV_CATEGORY_INDEX(SlashCombat),
+			CSV_CATEGORY_INDEX(SlashPickups),
+			CSV_CATEGORY_INDEX(SlashItems),
+			CSV_CATEGORY_INDEX(SlashHUD),
+			CSV_CATEGORY_INDEX(SlashFX),
+			CSV_CATEGORY_INDEX(SlashDebris),
+			CSV_CATEGORY_INDEX(SlashAnimation)
+		};
+		static_assert(UE_ARRAY_COUNT(CsvCategories) == static_cast<int32>(ESlashPerfBucket::SPB_MAX), "One CSV category per bucket");
+
+		for (int32 Index = 0; Index < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Index)
+		{
+			FCsvProfiler::RecordCustomStat("GameThreadMs", CsvCategories[Index], static_cast<float>(FPlatformTime::ToMilliseconds64(CurrentCycles[Index])), ECsvCustomStatOp::Set);
+		}
+		CSV_CUSTOM_STAT(SlashCombat, DamageEvents, CurrentDamageEvents, ECsvCustomStatOp::Set);
+	}
+#endif
+
+	for (int32 Index = 0; Index < static_cast<int32>(ESlashPerfBucket::SPB_MAX); ++Index)
+	{
+		const double FrameMs = FPlatformTime::ToMilliseconds64(CurrentCycles[Index]);
+		LastFrameMs[Index] = FrameMs;
+		AverageMs[Index] = FMath::Lerp(AverageMs[Index], FrameMs, 0.1);
+		CurrentCycles[Index] = 0;
+	}
+
+	LastDamageEvents = CurrentDamageEvents;
+	CurrentDamageEvents = 0;
+}
+
+const TCHAR* FSlashPerfCounters::GetBucketName(ESlashPerfBucket Bucket)
+{
+	switch (Bucket)
+	{
+	case ESlashPerfBucket::SPB_AI: return TEXT("AI");
+	case ESlashPerfBucket::SPB_Combat: return TEXT("Combat");
+	case ESlashPerfBucket::SPB_Pickups: return TEXT("Pickups");
+	case ESlashPerfBucket::SPB_Items: return TEXT("Items");
+	case ESlashPerfBucket::SPB_HUD: return TEXT("HUD");
+	case ESlashPerfBucket::SPB_FX: return TEXT("FX");
+	case ESlashPerfBucket::SPB_Debris: return TEXT("Debris");
+	case ESlashPerfBucket::SPB_Animation: return TEXT("Animation");
+	default: return TEXT("Unknown");
+	}
+}
+
+#if SLASH_PERF_COUNTERS
+
+FSlashPerfScope* FSlashPerfScope::Current = nullptr;
+
+FSlashPerfScope::FSlashPerfScope(ESlashPerfBucket InBucket)
+	: Bucket(InBucket)
+	, Parent(Current)
+{
+	StartCycles = FPlatformTime::Cycles64();
+	if (Parent)
+	{
+		FSlashPerfCounters::Get().AddCycles(Parent->Bucket, StartCycles - Parent->StartCycles);
+	}
+	Current = this;
+}
+
+FSlashPerfScope::~FSlashPerfScope()
+{
+	const uint64 EndCycles = FPlatformTime::Cycles64();
+	FSlashPerfCounters::Get().AddCycles(Bucket, EndCycles - StartCycles);
+
+	// The outer scope goes on from here
+	if (Parent)
+	{
+		Parent->StartCycles = EndCycles;
+	}
+	Current = Parent;
+}
+
+#endif
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Performance/SlashTrace.h"
+
+#if SLASH_TRACE_ENABLED
+
+#include "Particles/ParticleSystemComponent.h"
+#include "Misc/CoreDelegates.h"
+
+UE_TRACE_CHANNEL_DEFINE(SlashChannel);
+
+TRACE_DECLARE_INT_COUNTER(SlashLiveEnemies, TEXT("Slash/LiveEnemies"));
+TRACE_DECLARE_INT_COUNTER(SlashPickups, TEXT("Slash/Pickups"));
+TRACE_DECLARE_INT_COUNTER(SlashInstancedPickups, TEXT("Slash/InstancedPickups"));
+TRACE_DECLARE_INT_COUNTER(SlashActiveFX, TEXT("Slash/ActiveFX"));
+
+TArray<TWeakObjectPtr<UFXSystemComponent>> FSlashTrace::ActiveFX;
+bool FSlashTrace::bEndFrameBound = false;
+
+void FSlashTrace::TrackFX(UFXSystemComponent* FX)
+{
+	// Nobody is recording the counter, don't keep anything
+	if (FX == nullptr || !UE_TRACE_CHANNELEXPR_IS_ENABLED(CountersChannel)) return;
+
+	if (!bEndFrameBound)
+	{
+		FCoreDelegates::OnEndFrame.AddStatic(&FSlashTrace::EndFrame);
+		bEndFrameBound = true;
+	}
+	ActiveFX.Add(FX);
+}
+
+void FSlashTrace::EndFrame()
+{
+	if (ActiveFX.Num() == 0) return;
+
+	// FX spawned with auto destroy go away when they finish, the others just stop being active
+	ActiveFX.RemoveAllSwap([](const TWeakObjectPtr<UFXSystemComponent>& FX)
+	{
+		return !FX.IsValid() || !FX->IsActive();
+	});
+	TRACE_COUNTER_SET(SlashActiveFX, ActiveFX.Num());
+}
+
+#endif
@@ -12,6 +12,7 @@ class UGeometryCollectionComponent;
 class UCapsuleComponent;
 class ATreasure;
 class AHealth;
+class AChaosCacheManager;
 
 UCLASS()
 class SLASH_API ABreakableActor : public AActor, public IHitInterface
@@ -45,6 +46,31 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Breakable Properties")
 	float HealthAmount = 1.f;
 
+	/**
+	* Cached fracture playback.
+	* Instead of simulating the fracture live when hit, a Chaos Cache Manager placed in the level (Start Mode set to
+	*  Triggered, observing our GeometryCollection) plays back a fracture recorded in the editor.
+	* Live simulation stays as the fallback when the camera is close or the impact is far from the recorded one.
+	*/
+	UPROPERTY(EditInstanceOnly, Category = "Breakable Properties|Cached Fracture")
+	TObjectPtr<AChaosCacheManager> FractureCache;
+
+	// Closer than this to the camera, the fracture is simulated live so it reacts to the actual hit
+	UPROPERTY(EditAnywhere, Category = "Breakable Properties|Cached Fracture")
+	float LiveSimulationDistance = 600.f;
+
+	// Where the recorded fracture was hit, relative to this actor
+	UPROPERTY(EditAnywhere, Category = "Breakable Properties|Cached Fracture")
+	FVector RecordedImpactOffset = FVector::ZeroVector;
+
+	// Impacts farther than this from RecordedImpactOffset are simulated live. Zero accepts any impact
+	UPROPERTY(EditAnywhere, Category = "Breakable Properties|Cached Fracture")
+	float MaxImpactDeviation = 0.f;
+
+	bool bPlayingCachedFracture = false;
+
+	bool ShouldPlayCachedFracture(const FVector& ImpactPoint) const;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -65,4 +91,9 @@ public:
 
 	virtual void GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter) override;
 
+	/** Called by UDebrisSubsystem: stop simulating the pieces and leave them where they are */
+	void FreezeDebris();
+
+	/** The weapon doesn't need to create fields to break us when a recorded fracture is playing */
+	FORCEINLINE bool IsPlayingCachedFracture() const { return bPlayingCachedFracture; }
 };
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DebrisSubsystem.generated.h"
+
+class ABreakableActor;
+
+/**
+ * Keeps the physics cost of broken breakables bounded.
+ * Every ABreakableActor registers here when it breaks. Pieces simulate freely for a while, then they're put to
+ *  sleep (physics and collision off, they stay where they landed) and later removed or kept frozen.
+ * On top of that, the total number of simulating pieces is capped: when a new pot breaks over budget, the debris
+ *  farthest from the player is put to sleep first.
+ * Settings live in DefaultGame.ini under [/Script/Slash.DebrisSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UDebrisSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterDebris(ABreakableActor* Breakable, int32 NumPieces);
+
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	/** </UTickableWorldSubsystem> */
+
+	FORCEINLINE int32 GetNumSimulatingPieces() const { return NumSimulatingPieces; }
+	FORCEINLINE int32 GetNumDebris() const { return Debris.Num(); }
+
+private:
+	enum class EDebrisState : uint8
+	{
+		EDS_Simulating,
+		EDS_Sleeping
+	};
+
+	struct FDebrisEntry
+	{
+		TWeakObjectPtr<ABreakableActor> Breakable;
+		float BrokenTime = 0.f;
+		int32 NumPieces = 0;
+		EDebrisState State = EDebrisState::EDS_Simulating;
+	};
+
+	void ExpireDebris(float Now);
+	void EnforceBudget();
+	void SleepDebris(FDebrisEntry& Entry);
+
+	TArray<FDebrisEntry> Debris;
+
+	int32 NumSimulatingPieces = 0;
+
+	float TimeSinceUpdate = 0.f;
+
+	// Max number of pieces simulating at the same time in the whole level
+	UPROPERTY(Config)
+	int32 MaxSimulatingPieces = 300;
+
+	// Seconds the pieces simulate before being put to sleep
+	UPROPERTY(Config)
+	float SleepAfter = 4.f;
+
+	// Seconds after breaking until the debris is removed (or frozen for good if bRemoveExpiredDebris is false)
+	UPROPERTY(Config)
+	float ExpireAfter = 30.f;
+
+	UPROPERTY(Config)
+	bool bRemoveExpiredDebris = true;
+
+	// The debris is checked a few times per second, not every frame
+	UPROPERTY(Config)
+	float UpdateInterval = 0.25f;
+};
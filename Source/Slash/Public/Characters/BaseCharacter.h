@@ -22,6 +22,11 @@
 class AWeapon;
 class UAnimMontage;
 class UAttributeComponent;
+class UHurtboxComponent;
+class UBladeTrajectoryAsset;
+class UAttackFrameDataTable;
+class UMontagePlayerComponent;
+enum class EMontageType : uint8;
 
 UCLASS()
 class SLASH_API ABaseCharacter : public ACharacter, public IHitInterface
@@ -32,15 +37,15 @@ private:
 	/**
 	* Play Montage Functions
 	*/
-	// Generic function to play any montage!
-	void PlayMontageSection(UAnimMontage* Montage, const FName& SectionName);
+	// Generic function to play any montage! Goes through MontagePlayer, which caches the section indices
+	void PlayMontageSection(EMontageType Type, const FName& SectionName);
 	/**
 	* Play a random montage section. It also returns the selected index that represents the section name that will
 	*  be played.
 	* This will be called from functions that will pass the corresponding animation montage to play along with
 	*  their section names.
 	*/
-	int32 PlayRandomMontageSection(UAnimMontage* Montage, const TArray<FName>& SectionNames);
+	int32 PlayRandomMontageSection(EMontageType Type, const TArray<FName>& SectionNames);
 
 	UPROPERTY(EditAnywhere, Category = "Combat")
 	TObjectPtr<USoundBase> HitSound;
@@ -74,6 +79,22 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Combat")
 	TObjectPtr<UAnimMontage> DodgeMontage;
 
+	/** Baked blade path of every AttackMontage section. When set, our weapon hits from it instead of box traces */
+	UPROPERTY(EditDefaultsOnly, Category = "Combat")
+	TObjectPtr<UBladeTrajectoryAsset> BladeTrajectories;
+
+	/**
+	* Frame data extracted by the AttackFrameData commandlet. When set, AttackEnd() is also called from a timer at
+	*  the section's AttackEnd time, in case the notify callback never arrives (montage interrupted, notify skipped
+	*  by a hitch...).
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Combat")
+	TObjectPtr<UAttackFrameDataTable> FrameData;
+
+	FTimerHandle AttackEndFallbackTimer;
+	void ScheduleAttackEndFallback(const FName& SectionName);
+	void AttackEndFallback();
+
 protected:
 	/** <AActor> */
 	virtual void BeginPlay() override;
@@ -125,6 +146,7 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	FVector GetRotationWarpTarget();
 
+	/** Children should call Super::AttackEnd() so the fallback timer gets cleared */
 	UFUNCTION(BlueprintCallable)
 	virtual void AttackEnd();
 
@@ -143,6 +165,14 @@ protected:
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<UAttributeComponent> Attributes;
 
+	/** Per-bone capsules that weapons test against instead of the whole mesh. Set up its profile in BP */
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UHurtboxComponent> Hurtboxes;
+
+	/** Plays every montage of this character. Children register their own montages in BeginPlay */
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UMontagePlayerComponent> MontagePlayer;
+
 	// Pointer to store what has hit the enemy
 	UPROPERTY(BlueprintReadOnly, Category = "Combat")
 	TObjectPtr<AActor> CombatTarget;
@@ -155,9 +185,13 @@ protected:
 	TEnumAsByte<EDeathPose> DeathPose;
 
 public:
-	ABaseCharacter();
+	ABaseCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 	virtual void Tick(float DeltaTime) override;
 
+	/** All montages this character plays, used by tools that inspect them (e.g. the AttackFrameData commandlet) */
+	virtual void GetCombatMontages(TArray<UAnimMontage*>& OutMontages) const;
+
 	/** Getters and Setters */
 	FORCEINLINE TEnumAsByte<EDeathPose> GetDeathPose() const { return DeathPose; }
+	FORCEINLINE UAnimMontage* GetAttackMontage() const { return AttackMontage; }
 };
@@ -12,7 +12,9 @@ class ASlashCharacter;
 class UCharacterMovementComponent;
 
 /**
- * 
+ * The game thread only copies what it needs from the character into a snapshot (NativeUpdateAnimation); everything
+ *  the AnimGraph reads is computed from it in NativeThreadSafeUpdateAnimation, on a worker thread.
+ * The Animation Blueprint must have Use Multi Threaded Animation Update on and no logic in its EventGraph.
  */
 UCLASS()
 class SLASH_API USlashAnimInstance : public UAnimInstance
@@ -22,6 +24,7 @@ class SLASH_API USlashAnimInstance : public UAnimInstance
 public:
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaTime) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
 
 	UPROPERTY(BlueprintReadOnly)
 	ASlashCharacter* SlashCharacter;
@@ -52,4 +55,21 @@ public:
 
 	UPROPERTY(BlueprintReadOnly, Category = "Movement")
 	TEnumAsByte<EDeathPose> DeathPose;
+
+private:
+	/** Copied on the game thread, read on the worker thread */
+	struct FSlashAnimSnapshot
+	{
+		FVector Velocity = FVector::ZeroVector;
+		FRotator Rotation = FRotator::ZeroRotator;
+		bool bLocked = false;
+		bool bIsEnemy = false;
+		bool bIsFalling = false;
+		ECharacterState CharacterState = ECharacterState::ECS_Unequipped;
+		EActionState ActionState = EActionState::EAS_Unoccupied;
+		TEnumAsByte<EDeathPose> DeathPose = EDeathPose::EDP_MAX;
+	};
+
+	FSlashAnimSnapshot Snapshot;
+	bool bHasSnapshot = false;
 };
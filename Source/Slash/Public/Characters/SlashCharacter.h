@@ -28,6 +28,9 @@ class AWeapon;
 class UPawnSensingComponent;
 class AEnemy;
 class USlashOverlay;
+class USoulMagnetComponent;
+class UInputReplayComponent;
+enum class ESlashInputAction : uint8;
 
 UCLASS()
 class SLASH_API ASlashCharacter : public ABaseCharacter, public IPickupInterface
@@ -48,6 +51,9 @@ private:
 
 	bool CanJump();
 
+	/** Every bound input action goes through here, so UInputReplayComponent can record it (and block it during playback) */
+	void HandleInputAction(const FInputActionValue& Value, ESlashInputAction Action);
+
 	/** 
 	* Components
 	*/
@@ -63,6 +69,12 @@ private:
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<UGroomComponent> Eyebrows;
 
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<USoulMagnetComponent> SoulMagnet;
+
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UInputReplayComponent> InputReplay;
+
 	//UPROPERTY(VisibleAnywhere)
 	//TObjectPtr<UPawnSensingComponent> PawnSensing;
 
@@ -72,6 +84,14 @@ private:
 	UPROPERTY(VisibleInstanceOnly)
 	TObjectPtr<AItem> OverlappingItem;
 
+	/**
+	* Items in pickup range last frame, found with UPickupSubsystem. Items getting in range are notified like a
+	*  begin overlap, items getting out of it like an end overlap.
+	*/
+	TArray<TWeakObjectPtr<AItem>> NearbyPickups;
+
+	void UpdateNearbyPickups();
+
 	/** 
 	* Animation Montages 
 	*/
@@ -104,7 +124,6 @@ protected:
 	void EndSpeedUp(const FInputActionValue& Value);
 
 	void EKeyPressed();
-	void LeftButtonAttack();
 	void OneKeyAttack();
 	void TwoKeyAttack();
 	void ThreeKeyAttack();
@@ -118,7 +137,6 @@ protected:
 	void UnlockFromTarget();
 
 	/** Combat */
-	void EquipWeapon(AWeapon* Weapon);
 	virtual void AttackEnd() override;
 	virtual void DodgeEnd() override;
 	virtual bool CanAttack() override;
@@ -214,6 +232,10 @@ public:
 	virtual void GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter) override;
 	/** </IHitInterface> */
 
+	/** <ABaseCharacter> */
+	virtual void GetCombatMontages(TArray<UAnimMontage*>& OutMontages) const override;
+	/** </ABaseCharacter> */
+
 	/** <IPickupInterface> */
 	virtual void SetOverlappingItem(AItem* Item) override;
 	virtual void AddSouls(ASoul* Soul) override;
@@ -221,6 +243,16 @@ public:
 	virtual void AddHealth(AHealth* Health) override;
 	virtual void AddBook(ABook* Book) override;
 	/** </IPickupInterface> */
+
+	/** Also used to fight without input, e.g. by the stand-in of the combat benchmark and simulation (UCombatHarness) */
+	void EquipWeapon(AWeapon* Weapon);
+	void LeftButtonAttack();
+
+	/** Calls the handler of the input action, for live input and for UInputReplayComponent's playback */
+	void DispatchInputAction(ESlashInputAction Action, const FInputActionValue& Value);
+
+	/** Add many souls at once (e.g. everything USoulMagnetComponent collected this frame), with a single HUD update */
+	void CollectSouls(int32 NumberOfSouls);
 	
 	/** 
 	* Getters and Setters
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "AttackFrameData.generated.h"
+
+class UAnimMontage;
+
+/**
+* Timings of one montage section, extracted from its anim notifies by UAttackFrameDataCommandlet.
+* Times are montage positions in seconds. Negative means the notify wasn't found in the section.
+*/
+USTRUCT(BlueprintType)
+struct FAttackFrameEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	TSoftObjectPtr<UAnimMontage> Montage;
+
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	FName SectionName;
+
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	float SectionStart = 0.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	float SectionEnd = 0.f;
+
+	// Weapon collision enabled
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	float HitActiveStart = -1.f;
+
+	// Weapon collision disabled
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	float HitActiveEnd = -1.f;
+
+	// AttackEnd or HitReactEnd, whichever the section has
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	float ActionEnd = -1.f;
+
+	// Time from the end of the hit window until the character can act again
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	float Recovery = -1.f;
+
+	FORCEINLINE bool HasHitWindow() const { return HitActiveStart >= 0.f && HitActiveEnd >= 0.f; }
+	FORCEINLINE bool HasActionEnd() const { return ActionEnd >= 0.f; }
+};
+
+/**
+ * Compact table with the frame data of every montage used by our characters.
+ * Generated by running: UnrealEditor-Cmd Slash.uproject -run=AttackFrameData
+ */
+UCLASS(BlueprintType)
+class SLASH_API UAttackFrameDataTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	const FAttackFrameEntry* FindEntry(const UAnimMontage* Montage, const FName& SectionName) const;
+
+	UPROPERTY(VisibleAnywhere, Category = "Frame Data")
+	TArray<FAttackFrameEntry> Entries;
+};
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "BladeTrajectoryAsset.generated.h"
+
+class UAnimMontage;
+class USkeletalMesh;
+class AWeapon;
+
+/**
+* The blade of a weapon sampled at a fixed rate along one montage section.
+* Positions are in the character's mesh component space, so at runtime they only need the mesh's
+*  component transform to be placed in the world.
+*/
+USTRUCT()
+struct FBakedBladeSection
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Blade")
+	FName SectionName;
+
+	// Montage position of the first sample
+	UPROPERTY(VisibleAnywhere, Category = "Blade")
+	float StartTime = 0.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Blade")
+	float SampleInterval = 1.f / 60.f;
+
+	UPROPERTY()
+	TArray<FVector3f> BladeStart;
+
+	UPROPERTY()
+	TArray<FVector3f> BladeEnd;
+
+	FORCEINLINE int32 NumSamples() const { return BladeStart.Num(); }
+	FORCEINLINE float GetSampleTime(int32 Index) const { return StartTime + Index * SampleInterval; }
+};
+
+/**
+ * Blade trajectories of every section of an attack montage, baked in the editor.
+ * Pick the montage, the mesh and socket the weapon is attached to and the weapon class, then press Bake.
+ * At runtime AWeapon tests these baked segments against hurtboxes instead of reading the TraceStart/TraceEnd
+ *  components and doing box traces, so hits don't depend on the frame rate.
+ */
+UCLASS(BlueprintType)
+class SLASH_API UBladeTrajectoryAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	const FBakedBladeSection* FindSection(const FName& SectionName) const;
+
+	FORCEINLINE UAnimMontage* GetMontage() const { return Montage; }
+
+#if WITH_EDITOR
+	/** Sample every section of Montage and store the blade segments in Sections */
+	UFUNCTION(CallInEditor, Category = "Bake")
+	void Bake();
+#endif
+
+private:
+	UPROPERTY(EditAnywhere, Category = "Source")
+	TObjectPtr<UAnimMontage> Montage;
+
+	UPROPERTY(EditAnywhere, Category = "Source")
+	TObjectPtr<USkeletalMesh> Mesh;
+
+	UPROPERTY(EditAnywhere, Category = "Source")
+	FName WeaponSocketName = FName("RightHandSocket");
+
+	// Where TraceStart and TraceEnd are read from
+	UPROPERTY(EditAnywhere, Category = "Source")
+	TSubclassOf<AWeapon> WeaponClass;
+
+	UPROPERTY(EditAnywhere, Category = "Source", meta = (ClampMin = "10.0"))
+	float SampleRate = 60.f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Baked")
+	TArray<FBakedBladeSection> Sections;
+};
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "HurtboxProfile.generated.h"
+
+/**
+* A single capsule bound to a bone of the character's skeletal mesh.
+* The capsule's axis is the local Z axis after applying Offset and Rotation relative to the bone, just like
+*  a capsule component would be.
+*/
+USTRUCT(BlueprintType)
+struct FHurtboxCapsule
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Hurtbox")
+	FName BoneName;
+
+	// Used to tell which part of the body was hit (Head, Torso, Legs...)
+	UPROPERTY(EditAnywhere, Category = "Hurtbox")
+	FName Region;
+
+	UPROPERTY(EditAnywhere, Category = "Hurtbox")
+	FVector Offset = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, Category = "Hurtbox")
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	UPROPERTY(EditAnywhere, Category = "Hurtbox", meta = (ClampMin = "0.0"))
+	float Radius = 10.f;
+
+	UPROPERTY(EditAnywhere, Category = "Hurtbox", meta = (ClampMin = "0.0"))
+	float HalfHeight = 20.f;
+
+	// Multiplies the weapon damage when this capsule is the one that got hit
+	UPROPERTY(EditAnywhere, Category = "Hurtbox", meta = (ClampMin = "0.0"))
+	float DamageMultiplier = 1.f;
+};
+
+/**
+ * Set of hurtbox capsules for a character type (one for the Paladin, one for the Raptor, one for Echo...).
+ * All characters of the same type share the same asset, so the capsules are only authored once.
+ */
+UCLASS(BlueprintType)
+class SLASH_API UHurtboxProfile : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Hurtbox")
+	TArray<FHurtboxCapsule> Capsules;
+};
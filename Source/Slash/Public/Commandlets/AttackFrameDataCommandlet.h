@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Combat/AttackFrameData.h"
+#include "AttackFrameDataCommandlet.generated.h"
+
+class UAnimMontage;
+
+/**
+ * Loads every character Blueprint (anything derived from ABaseCharacter), reads the anim notifies of its
+ *  montages and writes the attack windows, recovery times and hit-active frames to a UAttackFrameDataTable.
+ * Inconsistent notifies (hit window that never closes, attack without AttackEnd...) are reported as errors.
+ *
+ * Usage: UnrealEditor-Cmd Slash.uproject -run=AttackFrameData [-Output=/Game/Data/DA_AttackFrameData]
+ *  [-HitStartNotify=EnableBoxCollision] [-HitEndNotify=DisableBoxCollision] [-NoSave]
+ * Returns 1 if any inconsistency was found, so it can gate a build.
+ */
+UCLASS()
+class SLASH_API UAttackFrameDataCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAttackFrameDataCommandlet();
+
+	/** <UCommandlet> */
+	virtual int32 Main(const FString& Params) override;
+	/** </UCommandlet> */
+
+private:
+	void ExtractMontage(UAnimMontage* Montage, const FString& Owner, TArray<FAttackFrameEntry>& OutEntries);
+	void ReportError(const FString& Owner, const UAnimMontage* Montage, const FName& SectionName, const TCHAR* Problem);
+
+	FName HitStartNotify = FName("EnableBoxCollision");
+	FName HitEndNotify = FName("DisableBoxCollision");
+	FName AttackEndNotify = FName("AttackEnd");
+	FName HitReactEndNotify = FName("HitReactEnd");
+
+	int32 NumErrors = 0;
+};
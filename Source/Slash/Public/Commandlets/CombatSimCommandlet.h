@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Performance/SlashPerfCounters.h"
+#include "CombatSimCommandlet.generated.h"
+
+class UCombatHarness;
+
+/**
+ * Combat simulation without a map, rendering or audio: creates an empty game world with a floor, spawns NumEnemies
+ *  enemies and an AI-possessed Echo stand-in (the same fight as the combat benchmark, see UCombatHarness), and ticks
+ *  the world NumTicks times as fast as possible. The stand-in keeps attacking the closest enemy, so the real AEnemy,
+ *  AWeapon and UAttributeComponent code runs (hits, damage, deaths, souls); dead enemies are replaced once their corpse
+ *  is destroyed.
+ * The JSON report has the ticks per second, the tick time, the heap allocations per tick (all threads, counted by a
+ *  proxy around GMalloc), the UObjects created and deleted (churn) and the FSlashPerfCounters buckets.
+ *
+ * Usage: UnrealEditor-Cmd Slash.uproject -run=CombatSim -nullrhi -nosound [-Enemies=N] [-Ticks=T] [-Output=Path.json]
+ *  [-GCInterval=Ticks]
+ * Defaults live in DefaultGame.ini under [/Script/Slash.CombatSimCommandlet], the enemy and stand-in classes under
+ *  [/Script/Slash.CombatHarness].
+ */
+UCLASS(Config = Game)
+class SLASH_API UCombatSimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCombatSimCommandlet();
+
+	/** <UCommandlet> */
+	virtual int32 Main(const FString& Params) override;
+	/** </UCommandlet> */
+
+private:
+	UWorld* CreateSimWorld();
+	void DestroySimWorld(UWorld* World);
+	void SpawnFloor(UWorld* World);
+	void SpawnEnemies(UWorld* World);
+	void TickWorld(UWorld* World);
+	bool WriteReport(const FString& Path, double TotalTickSeconds) const;
+
+	// -Enemies= overrides it
+	UPROPERTY(Config)
+	int32 NumEnemies = 20;
+
+	// Measured ticks, -Ticks= overrides it
+	UPROPERTY(Config)
+	int32 NumTicks = 3000;
+
+	// Game time of a tick is 1 / TickRate, however long the tick really takes
+	UPROPERTY(Config)
+	float TickRate = 30.f;
+
+	// Ticks not measured at the start, while everything spawns and settles
+	UPROPERTY(Config)
+	int32 WarmupTicks = 60;
+
+	// Close enough for the stand-in to reach them without navigation (the world has no navmesh)
+	UPROPERTY(Config)
+	float SpawnRadius = 150.f;
+
+	// Garbage is collected every this many ticks (the engine loop isn't running to do it), -GCInterval= overrides it
+	UPROPERTY(Config)
+	int32 GCInterval = 300;
+
+	UPROPERTY()
+	TObjectPtr<UCombatHarness> Harness;
+
+	/** One entry per measured tick */
+	TArray<float> TickMs;
+	TArray<float> AllocationsPerTick;
+	TArray<float> AllocatedBytesPerTick;
+	TArray<float> ObjectsCreatedPerTick;
+
+	int64 TotalObjectsCreated = 0;
+	int64 TotalObjectsDeleted = 0;
+	int32 LiveObjectsAtStart = 0;
+	int32 LiveObjectsAtEnd = 0;
+	int32 NumGarbageCollections = 0;
+	double TotalGCMs = 0.0;
+
+	double BucketTotalMs[static_cast<uint8>(ESlashPerfBucket::SPB_MAX)] = {};
+	int64 TotalDamageEvents = 0;
+};
@@ -35,6 +35,7 @@ public:
 	FORCEINLINE float GetSpeedUpCost() const { return SpeedUpCost; }
 	FORCEINLINE float GetStamina() const { return Stamina; }
 	FORCEINLINE float GetMaxStamina() const { return MaxStamina; }
+	FORCEINLINE bool IsStaminaFull() const { return Stamina >= MaxStamina; }
 
 protected:
 	// Called when the game starts
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HurtboxComponent.generated.h"
+
+class UHurtboxProfile;
+class USkeletalMeshComponent;
+
+/** Result of testing a weapon against the hurtboxes of a character */
+struct FHurtboxHit
+{
+	FVector ImpactPoint = FVector::ZeroVector;
+	FVector ImpactNormal = FVector::UpVector;
+	FName Region = NAME_None;
+	float DamageMultiplier = 1.f;
+};
+
+/**
+* Cheap per-bone hit volumes. Instead of tracing against the full skeletal mesh collision, weapons test
+*  their blade against a handful of capsules bound to bones.
+* This component doesn't tick: the capsules are only moved to the bones' current transform when a weapon
+*  asks for them (which only happens while a weapon window is open and the weapon is close to us), and at
+*  most once per frame. Idle characters cost nothing.
+*/
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SLASH_API UHurtboxComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UHurtboxComponent();
+
+	/**
+	* Sweep a sphere of SweepRadius from Start to End against our capsules.
+	* Returns true if any capsule was hit, filling OutHit with the capsule closest to Start.
+	*/
+	bool SweepSegment(const FVector& Start, const FVector& End, float SweepRadius, FHurtboxHit& OutHit);
+
+	/** False when there's no profile (or it's empty), so weapons know they should fall back to their box trace */
+	bool HasCapsules() const;
+
+	FORCEINLINE UHurtboxProfile* GetProfile() const { return Profile; }
+
+private:
+	/** Capsule already placed in world space: two end points of its segment plus the radius */
+	struct FWorldCapsule
+	{
+		FVector A;
+		FVector B;
+		float Radius;
+	};
+
+	void UpdateCapsules();
+
+	UPROPERTY(EditDefaultsOnly, Category = "Hurtbox")
+	TObjectPtr<UHurtboxProfile> Profile;
+
+	UPROPERTY()
+	TObjectPtr<USkeletalMeshComponent> OwnerMesh;
+
+	TArray<FWorldCapsule> WorldCapsules;
+
+	// Frame in which WorldCapsules were last updated, so many weapons in the same frame only update once
+	uint64 LastUpdateFrame = MAX_uint64;
+};
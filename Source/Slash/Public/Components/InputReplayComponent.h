@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InputActionValue.h"
+#include "InputReplayComponent.generated.h"
+
+class ASlashCharacter;
+
+/** Every input action bound in ASlashCharacter::SetupPlayerInputComponent, as stored in recordings */
+enum class ESlashInputAction : uint8
+{
+	ESIA_Move,
+	ESIA_Look,
+	ESIA_Jump,
+	ESIA_Equip,
+	ESIA_LeftAttack,
+	ESIA_OneKeyAttack,
+	ESIA_TwoKeyAttack,
+	ESIA_ThreeKeyAttack,
+	ESIA_LockTarget,
+	ESIA_Dodge,
+	ESIA_SpeedUp,
+	ESIA_EndSpeedUp,
+
+	ESIA_MAX
+};
+
+/**
+ * Records the input actions of Echo to a file and plays them back, so the same session can be replayed on another
+ *  build and the frame time traces compared.
+ * A recording holds the random seed (set when recording starts, and again when playback starts) and every action
+ *  with its time and value. Recording and playback both run at a fixed timestep (FixedFrameRate), so the per-frame
+ *  actions (Move, Look) land on the same frames; playback sends each action to Echo when its time is reached, and
+ *  live input is ignored meanwhile.
+ *
+ * -SlashRecordInput=Name records from the start, -SlashReplayInput=Name plays back from the start (add -ReplayExit
+ *  to quit at the end). Or the console commands Slash.Input.Record Name, Slash.Input.Stop and Slash.Input.Replay Name.
+ * Files are in Saved/InputRecordings/Name.slashinput.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SLASH_API UInputReplayComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInputReplayComponent();
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	void StartRecording(const FString& Name);
+	void StartPlayback(const FString& Name);
+	/** Stops recording (and saves the file) or playback */
+	void Stop();
+
+	/** Called by ASlashCharacter for every live input action */
+	void RecordAction(ESlashInputAction Action, const FInputActionValue& Value);
+
+	FORCEINLINE bool IsRecording() const { return bRecording; }
+	FORCEINLINE bool IsPlaying() const { return bPlaying; }
+
+	static FString GetRecordingPath(const FString& Name);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	struct FRecordedAction
+	{
+		float Time = 0.f;
+		ESlashInputAction Action = ESlashInputAction::ESIA_MAX;
+		EInputActionValueType ValueType = EInputActionValueType::Boolean;
+		FVector3f Value = FVector3f::ZeroVector;
+	};
+
+	bool Save();
+	bool Load(const FString& Path);
+	/** Both ways: FMemoryWriter on save, FMemoryReader on load */
+	void SerializeRecording(FArchive& Ar);
+
+	void UseFixedTimeStep();
+	void RestoreTimeStep();
+
+	UPROPERTY(EditAnywhere, Category = "Input Replay")
+	float FixedFrameRate = 60.f;
+
+	UPROPERTY()
+	TObjectPtr<ASlashCharacter> SlashCharacter;
+
+	TArray<FRecordedAction> Actions;
+	FString RecordingPath;
+	int32 RandomSeed = 0;
+
+	bool bRecording = false;
+	bool bPlaying = false;
+	bool bExitAfterPlayback = false;
+
+	/** From the command line, started once Echo is possessed by the player (usually after BeginPlay) */
+	FString PendingName;
+	bool bPendingPlayback = false;
+
+	/** The game's timestep before recording or playback, put back by Stop() */
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+
+	// World time when recording or playback started, action times are relative to it
+	double StartTime = 0.0;
+	int32 NextAction = 0;
+};
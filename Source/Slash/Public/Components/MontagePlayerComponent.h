@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MontagePlayerComponent.generated.h"
+
+class UAnimMontage;
+class UAnimInstance;
+
+/** What a montage is used for. Every character registers the montages it has */
+enum class EMontageType : uint8
+{
+	EMT_Attack,
+	EMT_HitReact,
+	EMT_Death,
+	EMT_Dodge,
+	EMT_Equip,
+	EMT_IdlePatrol,
+
+	EMT_MAX
+};
+
+/**
+* Plays the montages of a character.
+* Section names are resolved to an index (and a start time) once per montage and the montage is started directly
+*  at the section, instead of Montage_Play followed by Montage_JumpToSection(FName) every time.
+* Requests that wouldn't change anything are skipped: the same section asked twice in a frame, or a looping
+*  montage (like the idle patrol) asked again while it's still playing.
+*/
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SLASH_API UMontagePlayerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMontagePlayerComponent();
+
+	void RegisterMontage(EMontageType Type, UAnimMontage* Montage);
+
+	/**
+	* Play the section SectionName of the montage registered for Type.
+	* With bSkipIfPlaying, nothing happens while that montage is already playing (any section).
+	* Returns false if nothing was played.
+	*/
+	bool Play(EMontageType Type, const FName& SectionName, bool bSkipIfPlaying = false);
+	void Stop(EMontageType Type, float BlendOutTime);
+	bool IsPlaying(EMontageType Type) const;
+
+	/** Typed API */
+	FORCEINLINE bool PlayAttack(const FName& SectionName) { return Play(EMontageType::EMT_Attack, SectionName); }
+	FORCEINLINE bool PlayHitReact(const FName& SectionName) { return Play(EMontageType::EMT_HitReact, SectionName); }
+	FORCEINLINE bool PlayDeath(const FName& SectionName) { return Play(EMontageType::EMT_Death, SectionName); }
+	FORCEINLINE bool PlayDodge(const FName& SectionName) { return Play(EMontageType::EMT_Dodge, SectionName); }
+	FORCEINLINE bool PlayEquip(const FName& SectionName) { return Play(EMontageType::EMT_Equip, SectionName); }
+
+	FORCEINLINE UAnimMontage* GetMontage(EMontageType Type) const { return Montages[static_cast<uint8>(Type)].Montage; }
+
+private:
+	struct FCachedSection
+	{
+		int32 Index = INDEX_NONE;
+		float StartTime = 0.f;
+	};
+
+	struct FRegisteredMontage
+	{
+		TObjectPtr<UAnimMontage> Montage;
+		TMap<FName, FCachedSection> Sections;
+
+		// Last request, to skip it if it comes again in the same frame
+		FName LastSection = NAME_None;
+		uint64 LastFrame = 0;
+	};
+
+	const FCachedSection* FindSection(FRegisteredMontage& Registered, const FName& SectionName) const;
+	UAnimInstance* GetAnimInstance() const;
+
+	FRegisteredMontage Montages[static_cast<uint8>(EMontageType::EMT_MAX)];
+
+	// Keeps the registered montages referenced (FRegisteredMontage isn't a USTRUCT)
+	UPROPERTY()
+	TArray<TObjectPtr<UAnimMontage>> ReferencedMontages;
+};
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SoulMagnetComponent.generated.h"
+
+class ASoul;
+class ASlashCharacter;
+
+/**
+ * Pulls the souls around the player towards them and collects them on arrival, so there's no need to walk over
+ *  each one after a big fight.
+ * All homing souls are moved together: positions and velocities live in contiguous arrays and are integrated in a
+ *  single loop. The souls collected in a frame are added to the character at once (one HUD update).
+ * Souls are found through UPickupSubsystem, or with an overlap query when Slash.Pickups.UseIndex is off.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SLASH_API USoulMagnetComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USoulMagnetComponent();
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	FORCEINLINE int32 GetNumHomingSouls() const { return HomingSouls.Num(); }
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void AcquireSouls(const FVector& TargetLocation);
+	void IntegrateHoming(const FVector& TargetLocation, float DeltaTime);
+	void RemoveHomingAt(int32 Index);
+
+	UPROPERTY(EditAnywhere, Category = "Soul Magnet")
+	bool bMagnetEnabled = true;
+
+	// Souls closer than this start homing
+	UPROPERTY(EditAnywhere, Category = "Soul Magnet")
+	float MagnetRadius = 600.f;
+
+	// Souls closer than this are collected
+	UPROPERTY(EditAnywhere, Category = "Soul Magnet")
+	float CollectRadius = 60.f;
+
+	UPROPERTY(EditAnywhere, Category = "Soul Magnet")
+	float Acceleration = 3000.f;
+
+	UPROPERTY(EditAnywhere, Category = "Soul Magnet")
+	float MaxSpeed = 1500.f;
+
+	// Looking for new souls doesn't need to happen every frame
+	UPROPERTY(EditAnywhere, Category = "Soul Magnet")
+	float AcquireInterval = 0.1f;
+
+	float TimeSinceAcquire = 0.f;
+
+	/** One entry per homing soul, at the same index in every array */
+	UPROPERTY()
+	TArray<TObjectPtr<ASoul>> HomingSouls;
+
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+
+	// Indices of the souls that arrived this frame
+	TArray<int32> Arrived;
+
+	UPROPERTY()
+	TObjectPtr<ASlashCharacter> Character;
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CorpseSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Keeps the cost of ragdoll corpses bounded (see AEnemy::bRagdollCorpse).
+ * A ragdoll simulates for RagdollSleepAfter seconds and is then frozen where it lies. On top of that, no more than
+ *  MaxRagdolls simulate at the same time: when one more enemy dies, the oldest ragdoll is frozen first.
+ * Settings live in DefaultGame.ini under [/Script/Slash.CorpseSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UCorpseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterRagdoll(AEnemy* Enemy);
+
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	/** </UTickableWorldSubsystem> */
+
+	FORCEINLINE int32 GetNumRagdolls() const { return Ragdolls.Num(); }
+
+private:
+	struct FRagdollEntry
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		float StartTime = 0.f;
+	};
+
+	void FreezeRagdollAt(int32 Index);
+
+	// Oldest first
+	TArray<FRagdollEntry> Ragdolls;
+
+	UPROPERTY(Config)
+	int32 MaxRagdolls = 8;
+
+	UPROPERTY(Config)
+	float RagdollSleepAfter = 3.f;
+};
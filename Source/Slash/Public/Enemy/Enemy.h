@@ -21,7 +21,6 @@ class UPawnSensingComponent;
 class AWeapon;
 class ASoul;
 class UNiagaraComponent;
-class ULockedTargetComponent;
 
 UCLASS()
 class SLASH_API AEnemy : public ABaseCharacter
@@ -48,6 +47,20 @@ private:
 	void LoseInterest();
 	void HideHealthBar();
 
+	/**
+	* Tell the animation budget allocator how important this enemy's animation is: closer to a player is more
+	*  important, and enemies fighting are never skipped nor reduced, even when not rendered.
+	*/
+	void UpdateAnimationSignificance();
+
+	// Significance multiplier for enemies chasing or fighting the player
+	UPROPERTY(EditAnywhere, Category = "Animation Budget")
+	float CombatSignificanceScale = 4.f;
+
+	// Distance at which the significance is halved
+	UPROPERTY(EditAnywhere, Category = "Animation Budget")
+	float SignificanceDistance = 1500.f;
+
 	// Callback function to use with OnSeePawn delegate (UPawnSensingComponent). Bound in BeginPlay()
 	UFUNCTION() // to be bound to a delegate
 	void PawnSeen(APawn* SeenPawn);
@@ -145,6 +158,25 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Combat")
 	float DeathLifeSpan = 4.f;
 
+	/**
+	* Corpse
+	* Once the death montage is over (plus CorpseSettleTime, so the ABP can blend into the death pose), the corpse
+	*  stops costing anything: the pose is kept as is and animation, tick and movement are turned off.
+	* With bRagdollCorpse it goes limp instead, and UCorpseSubsystem freezes it later.
+	*/
+	void SettleCorpse(float DeltaTime);
+	void FreezeCorpse();
+	void StartRagdoll();
+	void StopCorpseWork();
+
+	UPROPERTY(EditAnywhere, Category = "Corpse")
+	bool bRagdollCorpse = false;
+
+	UPROPERTY(EditAnywhere, Category = "Corpse")
+	float CorpseSettleTime = 0.5f;
+
+	float TimeSinceDeathMontage = 0.f;
+
 	/** To spawn a soul when enemy dies. The amount for each enemy is set in BP in their Attributes component */
 	UPROPERTY(EditAnywhere, Category = "Combat")
 	TSubclassOf<ASoul> SoulClass;
@@ -152,6 +184,7 @@ private:
 protected:
 	/** <AActor> */
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	/** </AActor> */
 
 	/** <ABaseCharacter> */
@@ -166,15 +199,14 @@ protected:
 
 	void SpawnSoul();
 	/** States */
+	// Every state change goes through here, so it shows up as a bookmark in Unreal Insights
+	void SetEnemyState(EEnemyState NewState);
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly) // This specifier only works for non-private variables!
 	EEnemyState EnemyState = EEnemyState::EES_Patrolling;
 
-	/** Locked effects */
-	UPROPERTY(EditAnywhere)
-	TObjectPtr<ULockedTargetComponent> LockedEffectWidget;
-
 public:
-	AEnemy();
+	/** The mesh is budgeted by the AnimationBudgetAllocator plugin (see UpdateAnimationSignificance()) */
+	AEnemy(const FObjectInitializer& ObjectInitializer);
 
 	/** <AActor> */
 	virtual void Tick(float DeltaTime) override;
@@ -200,8 +232,19 @@ public:
 	virtual void GetHit_Implementation(const FVector& ImpactPoint, AActor* Hitter) override;
 	/** </IHitInterface> */
 
+	/** <ABaseCharacter> */
+	virtual void GetCombatMontages(TArray<UAnimMontage*>& OutMontages) const override;
+	/** </ABaseCharacter> */
+
 	bool IsDead();
 
+	/** Called by UCorpseSubsystem: stop simulating the ragdoll and keep it where it lies */
+	void FreezeRagdoll();
+	FORCEINLINE EEnemyState GetEnemyState() const { return EnemyState; }
+	// The controller asked for a path and is still waiting for it
+	bool IsWaitingForPath() const;
+
+	/** The lock-on reticle is shared by all enemies and owned by the player's ASlashHUD */
 	void ShowLockedEffect();
 	void HideLockedEffect();
 };
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Characters/CharacterTypes.h"
+#include "EnemyAnimInstance.generated.h"
+
+/** Forward declaration */
+class AEnemy;
+class UCharacterMovementComponent;
+
+/**
+ * Base class for the enemy Animation Blueprints (Paladin, Raptor...), same pattern as USlashAnimInstance:
+ *  the game thread copies a snapshot of the enemy and the AnimGraph properties are computed from it on a worker thread.
+ * Reparent the ABPs to this class, turn on Use Multi Threaded Animation Update and move the EventGraph logic here.
+ */
+UCLASS()
+class SLASH_API UEnemyAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NativeInitializeAnimation() override;
+	virtual void NativeUpdateAnimation(float DeltaTime) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
+
+	UPROPERTY(BlueprintReadOnly)
+	TObjectPtr<AEnemy> Enemy;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	TObjectPtr<UCharacterMovementComponent> EnemyMovement;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	float GroundSpeed;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	float Direction;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	bool IsFalling;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	bool bIsDead;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	EEnemyState EnemyState;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Movement")
+	TEnumAsByte<EDeathPose> DeathPose;
+
+private:
+	/** Copied on the game thread, read on the worker thread */
+	struct FEnemyAnimSnapshot
+	{
+		FVector Velocity = FVector::ZeroVector;
+		FRotator Rotation = FRotator::ZeroRotator;
+		bool bIsFalling = false;
+		EEnemyState EnemyState = EEnemyState::EES_Patrolling;
+		TEnumAsByte<EDeathPose> DeathPose = EDeathPose::EDP_MAX;
+	};
+
+	FEnemyAnimSnapshot Snapshot;
+	bool bHasSnapshot = false;
+};
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HealthBarSubsystem.generated.h"
+
+class USceneComponent;
+
+/**
+ * Health of every enemy health bar in the world, in compact arrays (one slot per UMyHealthBarComponent).
+ * Nothing is drawn here: ASlashHUD::DrawHUD() goes through the slots once per frame and draws the bars itself,
+ *  so there are no widgets at all, however many enemies there are.
+ */
+UCLASS()
+class SLASH_API UHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns the slot of the new bar, to pass to the setters */
+	int32 RegisterBar(USceneComponent* Anchor);
+	void UnregisterBar(int32 Slot);
+
+	FORCEINLINE void SetPercent(int32 Slot, float Percent) { if (Percents.IsValidIndex(Slot)) Percents[Slot] = Percent; }
+	FORCEINLINE void SetVisible(int32 Slot, bool bVisible) { if (Visible.IsValidIndex(Slot)) Visible[Slot] = bVisible; }
+
+	/** Read by the HUD. Free slots have no anchor */
+	FORCEINLINE int32 GetNumSlots() const { return Anchors.Num(); }
+	FORCEINLINE const USceneComponent* GetAnchor(int32 Slot) const { return Anchors[Slot].Get(); }
+	FORCEINLINE float GetPercent(int32 Slot) const { return Percents[Slot]; }
+	FORCEINLINE bool IsVisible(int32 Slot) const { return Visible[Slot] != 0; }
+
+private:
+	TArray<TWeakObjectPtr<USceneComponent>> Anchors;
+	TArray<float> Percents;
+	TArray<uint8> Visible;
+
+	TArray<int32> FreeSlots;
+};
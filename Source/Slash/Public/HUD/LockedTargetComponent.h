@@ -1,17 +0,0 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Components/WidgetComponent.h"
-#include "LockedTargetComponent.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SLASH_API ULockedTargetComponent : public UWidgetComponent
-{
-	GENERATED_BODY()
-	
-};
@@ -3,22 +3,27 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Components/WidgetComponent.h"
+#include "Components/SceneComponent.h"
 #include "MyHealthBarComponent.generated.h"
 
 /**
- * 
+ * Where an enemy's health bar goes (place it above the head). It's not a widget anymore: it only writes the health
+ *  and visibility into UHealthBarSubsystem, and ASlashHUD draws all the bars at once.
  */
 UCLASS()
-class SLASH_API UMyHealthBarComponent : public UWidgetComponent
+class SLASH_API UMyHealthBarComponent : public USceneComponent
 {
 	GENERATED_BODY()
 
 public:
-	/** Access the user widget used by this component and set its percentage */
+	/** Set the percentage shown by the bar */
 	void SetHealthBarPercent(float Percent);
 
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnVisibilityChanged() override;
+
 private:
-	UPROPERTY()
-	TObjectPtr<class UHealthBar> HealthBarWidget;
+	int32 BarSlot = INDEX_NONE;
 };
@@ -11,6 +11,8 @@
  */
 
 class USlashOverlay;
+class UHealthBarSubsystem;
+class UUserWidget;
 
 UCLASS()
 class SLASH_API ASlashHUD : public AHUD
@@ -24,9 +26,78 @@ private:
 	UPROPERTY()
 	TObjectPtr<USlashOverlay> SlashOverlay;
 
+	/**
+	* Enemy health bars
+	* All of them are drawn here on the canvas from UHealthBarSubsystem, instead of a widget component per enemy.
+	* Bars too far from the camera, behind it, or on enemies that weren't rendered last frame (occluded or off screen)
+	*  are skipped.
+	*/
+	void DrawHealthBars(UHealthBarSubsystem* HealthBars);
+
+	UPROPERTY(EditDefaultsOnly, Category = "Health Bars")
+	FVector2D HealthBarSize = FVector2D(80.f, 8.f);
+
+	UPROPERTY(EditDefaultsOnly, Category = "Health Bars")
+	FLinearColor HealthBarColor = FLinearColor(0.6f, 0.02f, 0.02f);
+
+	UPROPERTY(EditDefaultsOnly, Category = "Health Bars")
+	FLinearColor HealthBarBackgroundColor = FLinearColor(0.f, 0.f, 0.f, 0.6f);
+
+	UPROPERTY(EditDefaultsOnly, Category = "Health Bars")
+	float MaxHealthBarDistance = 3000.f;
+
+	// Only enemies that already lost some health get a bar
+	UPROPERTY(EditDefaultsOnly, Category = "Health Bars")
+	bool bOnlyDamagedHealthBars = true;
+
+	/**
+	* Lock-on reticle
+	* Only one enemy can be locked at a time, so there's a single reticle widget that follows it.
+	* Without a LockedReticleClass (set it in BP_SlashHUD), a diamond is drawn on the canvas instead.
+	*/
+	void UpdateLockedReticle();
+	void DrawLockedMarker();
+
+	UPROPERTY(EditDefaultsOnly, Category = "Lock On")
+	TSubclassOf<UUserWidget> LockedReticleClass;
+
+	// Half the width of the canvas diamond drawn when there's no LockedReticleClass
+	UPROPERTY(EditDefaultsOnly, Category = "Lock On")
+	float LockedMarkerSize = 10.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Lock On")
+	FLinearColor LockedMarkerColor = FLinearColor(1.f, 0.25f, 0.f);
+
+	UPROPERTY()
+	TObjectPtr<UUserWidget> LockedReticle;
+
+	// Where the reticle goes, from the locked actor's location
+	UPROPERTY(EditDefaultsOnly, Category = "Lock On")
+	FVector LockedReticleOffset = FVector(0.f, 0.f, 15.f);
+
+	TWeakObjectPtr<AActor> LockedTarget;
+
+	/**
+	* Perf overlay (Slash.PerfOverlay 1, not in shipping builds)
+	* Counts of what the Slash systems are working on and their game thread time, from FSlashPerfCounters.
+	*  Nothing is gathered while it's hidden.
+	*/
+	void DrawPerfOverlay();
+
+	UPROPERTY(EditDefaultsOnly, Category = "Perf Overlay")
+	FVector2D PerfOverlayPosition = FVector2D(20.f, 200.f);
+
+	UPROPERTY(EditDefaultsOnly, Category = "Perf Overlay")
+	FLinearColor PerfOverlayColor = FLinearColor::Yellow;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void DrawHUD() override;
 
 public:
 	FORCEINLINE USlashOverlay* GetSlashOverlay() const { return SlashOverlay; }
+
+	void ShowLockedReticle(AActor* Target);
+	// Only hides it if Target is the one that's locked
+	void HideLockedReticle(const AActor* Target);
 };
@@ -7,11 +7,14 @@
 #include "SlashOverlay.generated.h"
 
 /**
- * 
+ * The overlay keeps the last value it shows for everything, and only touches a widget when what's visible changes:
+ *  bars are quantized to BarSteps, numbers only get a new FText when they're different.
+ * Put the content in an InvalidationBox named OverlayInvalidationBox so Slate caches it between changes.
  */
 
 class UProgressBar;
 class UTextBlock;
+class UInvalidationBox;
 
 UCLASS()
 class SLASH_API USlashOverlay : public UUserWidget
@@ -35,6 +38,27 @@ private:
 	UPROPERTY(meta = (BindWidget))
 	TObjectPtr<UTextBlock> BooksText;
 
+	UPROPERTY(meta = (BindWidgetOptional))
+	TObjectPtr<UInvalidationBox> OverlayInvalidationBox;
+
+	/** Returns true if the bar had to change */
+	bool SetBarPercent(UProgressBar* Bar, float Percent, int32& LastStep);
+	void SetNumberText(UTextBlock* Text, int32 Value, int32& LastValue);
+
+	// A bar doesn't show more precision than this (about one pixel for a 200 pixels wide bar)
+	UPROPERTY(EditDefaultsOnly, Category = "Slash", meta = (ClampMin = "1"))
+	int32 BarSteps = 200;
+
+	/** Last values shown, INDEX_NONE when nothing was shown yet */
+	int32 LastHealthStep = INDEX_NONE;
+	int32 LastStaminaStep = INDEX_NONE;
+	int32 LastGold = INDEX_NONE;
+	int32 LastSouls = INDEX_NONE;
+	int32 LastBooks = INDEX_NONE;
+
+protected:
+	virtual void NativeConstruct() override;
+
 public:
 	/** Setters and Getters */
 	void SetHealthBarPercent(float Percent);
@@ -31,4 +31,9 @@ public:
 	/** Getters and Setters */
 	FORCEINLINE int32 GetBooks() const { return Books; }
 	FORCEINLINE void SetBooks(int32 NumberOfBooks) { Books = NumberOfBooks; }
+
+	/** <AItem> */
+	virtual float GetPickupValue() const override { return Books; }
+	virtual void SetPickupValue(float Value) override { Books = FMath::RoundToInt(Value); }
+	/** </AItem> */
 };
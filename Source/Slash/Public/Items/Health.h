@@ -31,4 +31,9 @@ protected:
 public:
 	FORCEINLINE float GetHealth() const { return Health; }
 	FORCEINLINE void SetHealth(float AmountOfHealth) { Health = AmountOfHealth; }
+
+	/** <AItem> */
+	virtual float GetPickupValue() const override { return Health; }
+	virtual void SetPickupValue(float Value) override { Health = Value; }
+	/** </AItem> */
 };
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InstancedPickupSubsystem.generated.h"
+
+class AItem;
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Draws pickups (treasure, health, books...) with one instanced static mesh component per mesh instead of one
+ *  actor each.
+ * An item with bRenderInstanced turns itself into a compact entry here when it begins play (class, transform
+ *  and value) and is destroyed. When the player gets within PromoteRadius, the entry becomes a real actor again
+ *  so it can be picked up; when the player goes farther than DemoteRadius, it goes back to being an instance.
+ * Instances don't hover (unless their material does it) and have no Niagara effect.
+ * Settings live in DefaultGame.ini under [/Script/Slash.InstancedPickupSubsystem].
+ */
+UCLASS(Config = Game)
+class SLASH_API UInstancedPickupSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns true if Item is now drawn as an instance, in which case it has been destroyed */
+	bool AddInstancedPickup(AItem* Item);
+
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	/** </UTickableWorldSubsystem> */
+
+	FORCEINLINE int32 GetNumInstancedPickups() const { return Pickups.Num(); }
+
+private:
+	struct FInstancedPickup
+	{
+		TSubclassOf<AItem> Class;
+		FTransform Transform;
+		float Value = 0.f;
+		int32 MeshIndex = INDEX_NONE;
+		int32 InstanceIndex = INDEX_NONE;
+	};
+
+	/** One per mesh. Removed instances are only hidden and their slot is reused, so indices never shift */
+	struct FPickupMesh
+	{
+		TObjectPtr<UStaticMesh> Mesh;
+		TObjectPtr<UInstancedStaticMeshComponent> Instances;
+		TArray<int32> FreeInstances;
+	};
+
+	int32 FindOrAddMesh(AItem* Item);
+	void PromotePickups(const FVector& PlayerLocation);
+	void DemotePickups(const FVector& PlayerLocation);
+
+	TArray<FInstancedPickup> Pickups;
+	TArray<FPickupMesh> Meshes;
+
+	// The ISM components live here, no other actor needs them
+	UPROPERTY()
+	TObjectPtr<AActor> RendererActor;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UInstancedStaticMeshComponent>> InstanceComponents;
+
+	// Items made real actors again, which go back to instances when the player walks away
+	TArray<TWeakObjectPtr<AItem>> PromotedItems;
+
+	float TimeSinceUpdate = 0.f;
+
+	UPROPERTY(Config)
+	float PromoteRadius = 600.f;
+
+	// Bigger than PromoteRadius so items don't keep switching when the player stands at the border
+	UPROPERTY(Config)
+	float DemoteRadius = 900.f;
+
+	UPROPERTY(Config)
+	float UpdateInterval = 0.2f;
+};
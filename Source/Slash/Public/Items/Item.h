@@ -31,9 +31,27 @@ private:
 	UPROPERTY(EditAnywhere)
 	TObjectPtr<UNiagaraSystem> PickupEffect;
 
+	// Height offset applied by the last TickHover(), so the next one only moves by the difference
+	float AppliedHoverOffset = 0.f;
+
+	bool bRegisteredForHover = false;
+
+	// In UPickupSubsystem's index instead of using the Sphere overlaps
+	bool bRegisteredForPickup = false;
+
+	// Spawned by UInstancedPickupSubsystem because the player got close, so don't turn into an instance again
+	bool bPromotedFromInstance = false;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Stop being moved by UItemMotionSubsystem (e.g. once equipped) */
+	void StopHovering();
+
+	/** Can't be picked up anymore: leave UPickupSubsystem's index (e.g. once equipped) */
+	void StopBeingPickup();
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sine Parameters")
 	float Amplitude = 0.25f;
@@ -42,6 +60,25 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rotation")
 	float RotationRate = 100.f;
 
+	// Spin around Z at RotationRate degrees per second while hovering
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rotation")
+	bool bSpin = false;
+
+	/**
+	* The hover (and spin) is done by the item's material with World Position Offset, so there's no need to move
+	*  the actor on the CPU. Only use it when no gameplay depends on where the mesh is.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Sine Parameters")
+	bool bHoverInMaterial = false;
+
+	/**
+	* Drawn by UInstancedPickupSubsystem together with every other pickup using the same mesh, and only made a real
+	*  actor when the player gets close. For pickups that stay where they are (treasure, health, books). Only applies
+	*  to items placed in the level, spawned ones (e.g. dropped by breakables) are always real actors.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Instancing")
+	bool bRenderInstanced = false;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TObjectPtr<UStaticMeshComponent> ItemMesh;
 
@@ -89,6 +126,34 @@ public:
 	// Sets default values for this actor's properties
 	AItem();
 	
-	// Called every frame
+	// Called every frame. Items don't tick by default, the hover is done by UItemMotionSubsystem
 	virtual void Tick(float DeltaTime) override;
+
+	/**
+	* Called by UItemMotionSubsystem every frame while hovering.
+	* The hover time always advances, but the actor is only moved when bVisible.
+	*/
+	void TickHover(float DeltaTime, bool bVisible);
+
+	/**
+	* Called by the character when it gets in (or out of) the pickup range found with UPickupSubsystem, instead of
+	*  the Sphere's begin and end overlap events. Same behavior as the overlaps.
+	*/
+	void NotifyPickupEnter(AActor* Picker);
+	void NotifyPickupExit(AActor* Picker);
+
+	FVector GetPickupLocation() const;
+
+	/**
+	* Used by UInstancedPickupSubsystem to keep what a pickup is worth (gold, health, books...) while it's only an instance
+	*/
+	virtual float GetPickupValue() const { return 0.f; }
+	virtual void SetPickupValue(float Value) {}
+
+	// Transform of the item without the hover offset
+	FTransform GetRestTransform() const;
+
+	FORCEINLINE void MarkPromotedFromInstance() { bPromotedFromInstance = true; }
+	FORCEINLINE bool IsPickupHovering() const { return ItemState == EItemState::EIS_Hovering; }
+	FORCEINLINE UStaticMeshComponent* GetItemMesh() const { return ItemMesh; }
 };
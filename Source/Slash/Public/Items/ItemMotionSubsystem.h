@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemMotionSubsystem.generated.h"
+
+class AItem;
+class ASoul;
+class UCurveFloat;
+
+/**
+ * Moves every hovering item of the world in a single tick, instead of each AItem ticking on its own.
+ * Items nobody has seen recently don't move at all (their hover time still runs, so they're at the right height
+ *  as soon as they're visible again).
+ * Souls dropped by enemies also descend to the ground here, all together, and are forgotten once they're settled.
+ * Use the console command Slash.Items.ReportMotion to print how much game thread time this costs.
+ */
+UCLASS()
+class SLASH_API UItemMotionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterHoveringItem(AItem* Item);
+	void UnregisterHoveringItem(AItem* Item);
+
+	/**
+	* Move Soul down to TargetZ at Speed units per second. If Curve is set, it shapes the descent: it maps the
+	*  normalized time (0 to 1) to the normalized height travelled (0 to 1).
+	*/
+	void StartDescent(ASoul* Soul, double TargetZ, double Speed, UCurveFloat* Curve);
+	void StopDescent(ASoul* Soul);
+
+	/**
+	* Height of the ground below Location. It comes from the navmesh and is cached in cells, so many souls dropped
+	*  at the same place only ask once. Falls back to a line trace where there's no navmesh.
+	*/
+	bool FindGroundHeight(const FVector& Location, const AActor* IgnoredActor, double& OutGroundZ);
+
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	/** </UTickableWorldSubsystem> */
+
+	void ReportMotionCost() const;
+
+	FORCEINLINE int32 GetNumHoveringItems() const { return HoveringItems.Num(); }
+	FORCEINLINE int32 GetNumDescendingSouls() const { return DescendingSouls.Num(); }
+
+private:
+	void TickDescent(float DeltaTime);
+	void RemoveDescentAt(int32 Index);
+
+	UPROPERTY()
+	TArray<TObjectPtr<AItem>> HoveringItems;
+
+	/**
+	* Descending souls, one entry per soul at the same index in every array, so the update runs over contiguous data
+	*/
+	UPROPERTY()
+	TArray<TObjectPtr<ASoul>> DescendingSouls;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UCurveFloat>> DescentCurves;
+
+	TArray<double> DescentStartZ;
+	TArray<double> DescentTargetZ;
+	// Height the descent has moved the soul to so far (the hover moves it too, so we only apply differences)
+	TArray<double> DescentAppliedZ;
+	TArray<float> DescentElapsed;
+	TArray<float> DescentDuration;
+
+	// Ground heights already found, by cell
+	TMap<FIntVector, double> GroundHeightCache;
+	float GroundCellSize = 100.f;
+
+	// Average over the last frames, in milliseconds
+	double AverageUpdateMs = 0.0;
+	int32 NumMovedLastUpdate = 0;
+
+	// Items not rendered for longer than this (in seconds) aren't moved
+	float VisibilityTimeout = 0.25f;
+};
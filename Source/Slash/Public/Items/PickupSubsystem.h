@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Spatial index of every item that can be picked up, in a 2D grid of cells.
+ * Instead of each item having an overlap sphere in the physics scene, the player asks this index every frame
+ *  which items are within pickup range (see ASlashCharacter::UpdateNearbyPickups()).
+ * Items only move up and down while they're in the index (hover, soul descent), so the cell of an item never
+ *  changes: the query reads their real location anyway.
+ * The console variable Slash.Pickups.UseIndex turns it off, going back to the overlap spheres.
+ */
+UCLASS()
+class SLASH_API UPickupSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static bool IsIndexEnabled();
+
+	void RegisterPickup(AItem* Item, float Radius);
+	void UnregisterPickup(AItem* Item);
+
+	/**
+	* Items whose pickup sphere touches the capsule going from SegmentStart to SegmentEnd with the radius CapsuleRadius,
+	*  which is what the overlap sphere would have reported for the player's capsule.
+	*/
+	void QueryPickups(const FVector& SegmentStart, const FVector& SegmentEnd, float CapsuleRadius, TArray<AItem*>& OutItems) const;
+
+	FORCEINLINE int32 GetNumPickups() const { return Pickups.Num(); }
+
+private:
+	struct FPickupEntry
+	{
+		TWeakObjectPtr<AItem> Item;
+		float Radius = 0.f;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	TMap<FIntPoint, TArray<FPickupEntry>> Cells;
+
+	// Cell of every registered item, to find it again when unregistering
+	TMap<TObjectKey<AItem>, FIntPoint> Pickups;
+
+	float CellSize = 500.f;
+
+	// Biggest pickup radius registered, so the query knows how many cells around it to look at
+	float MaxPickupRadius = 0.f;
+};
@@ -6,8 +6,10 @@
 #include "Items/Item.h"
 #include "Soul.generated.h"
 
+class UCurveFloat;
+
 /**
- * 
+ * Souls don't tick: UItemMotionSubsystem moves them down to the ground and forgets them once they're settled.
  */
 
 UCLASS()
@@ -24,8 +26,17 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Soul Properties")
 	double DriftRate = -20.;
 
+	// Optional shape of the descent (normalized time to normalized height travelled). Linear when not set
+	UPROPERTY(EditAnywhere, Category = "Soul Properties")
+	TObjectPtr<UCurveFloat> DescentCurve;
+
+	// How high above the ground the soul settles
+	UPROPERTY(EditAnywhere, Category = "Soul Properties")
+	double HeightAboveGround = 100.;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	virtual void OnSphereOverlap(
 		UPrimitiveComponent* OverlappedComponent,
@@ -37,7 +48,12 @@ protected:
 	) override;
 
 public:
-	virtual void Tick(float DeltaTime) override;
+	/** Called by USoulMagnetComponent: the soul stops descending and hovering, and can't be picked up by walking over it */
+	void StartHoming();
+
+	/** Called by USoulMagnetComponent when the soul reached the player. Returns the souls collected */
+	int32 CollectByMagnet();
+
 	/** Getters and Setters */
 	FORCEINLINE int32 GetSouls() const { return Souls; }
 	FORCEINLINE void SetSouls(int32 NumberOfSouls) { Souls = NumberOfSouls; }
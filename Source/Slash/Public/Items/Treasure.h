@@ -32,4 +32,9 @@ protected:
 
 public:
 	FORCEINLINE int32 GetGold() const { return Gold; }
+
+	/** <AItem> */
+	virtual float GetPickupValue() const override { return Gold; }
+	virtual void SetPickupValue(float Value) override { Gold = FMath::RoundToInt(Value); }
+	/** </AItem> */
 };
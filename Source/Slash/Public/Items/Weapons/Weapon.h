@@ -8,6 +8,10 @@
 
 class USoundBase;
 class UBoxComponent;
+class UBladeTrajectoryAsset;
+class UHurtboxComponent;
+class USkeletalMeshComponent;
+struct FBakedBladeSection;
 
 /**
  * 
@@ -19,6 +23,7 @@ class SLASH_API AWeapon : public AItem
 
 public:
 	AWeapon();
+	virtual void Tick(float DeltaTime) override;
 	// Attaches the Item mesh to the character's Skeletal mesh and set the Item state to equipped.
 	// Called in character class once the E key is pressed.
 	void Equip(USceneComponent* InParent, FName InSocketName, AActor* NewOwner, APawn* NewInstigator);
@@ -27,6 +32,13 @@ public:
 	void PlayEquipSound();
 	void AttachMeshToSocket(USceneComponent* InParent, const FName& InSocketName);
 
+	/**
+	* Hit detection from a baked blade trajectory instead of the weapon box. Called when the wielder enables/disables
+	*  weapon collision. Only characters with hurtboxes are hit this way, the rest still use the weapon box.
+	*/
+	void BeginBakedSwing(UBladeTrajectoryAsset* Trajectories, USkeletalMeshComponent* InWielderMesh);
+	void EndBakedSwing();
+
 	// Get track of the actors hit
 	TArray<AActor*> IgnoreActors;
 
@@ -34,6 +46,8 @@ public:
 	* Getter and Setter
 	*/
 	FORCEINLINE UBoxComponent* GetWeaponBox() const { return WeaponBox; }
+	FORCEINLINE USceneComponent* GetTraceStart() const { return TraceStart; }
+	FORCEINLINE USceneComponent* GetTraceEnd() const { return TraceEnd; }
 	
 protected:
 	virtual void BeginPlay() override;
@@ -52,6 +66,9 @@ protected:
 
 	void ExecuteGetHit(FHitResult& BoxHit);
 
+	// Apply damage, call GetHit on the hit actor and create the fields
+	void ApplyHit(FHitResult& BoxHit, float DamageMultiplier);
+
 	/** 
 	* Create some Transient Field.
 	* @param		FieldLocation To know where that field should be
@@ -64,6 +81,33 @@ protected:
 private:
 	void BoxTrace(FHitResult& BoxHit);
 
+	/**
+	* Test the blade (TraceStart to TraceEnd) against the hurtbox capsules of OtherActor.
+	* Returns false if OtherActor has no hurtboxes, so the caller falls back to BoxTrace().
+	* When it returns true, BoxHit only has an actor if a capsule was actually hit.
+	*/
+	bool HurtboxTrace(AActor* OtherActor, FHitResult& BoxHit, float& OutDamageMultiplier);
+	bool HasHurtboxes(AActor* OtherActor) const;
+
+	void UpdateBakedSwing();
+
+	UPROPERTY()
+	TObjectPtr<UBladeTrajectoryAsset> ActiveTrajectories;
+
+	UPROPERTY()
+	TObjectPtr<USkeletalMeshComponent> WielderMesh;
+
+	// Points into ActiveTrajectories, which isn't modified at runtime
+	const FBakedBladeSection* ActiveSection = nullptr;
+
+	float LastSwingPosition = 0.f;
+
+	TArray<TWeakObjectPtr<UHurtboxComponent>> SwingCandidates;
+
+	// How far from the wielder we look for characters to hit when a baked swing begins
+	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
+	float SwingCandidateRadius = 400.f;
+
 	UPROPERTY(EditAnywhere, Category = "Weapon Properties")
 	FVector BoxTraceExtent = FVector{ 5.f };
 
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Performance/SlashPerfCounters.h"
+#include "CombatBenchmarkSubsystem.generated.h"
+
+class UCombatHarness;
+
+/**
+ * Headless combat benchmark, only created when the game runs with -SlashBenchmark.
+ * Spawns NumEnemies enemies in rings around the first player start, and an Echo stand-in possessed by an AI
+ *  controller that keeps walking to the closest enemy and attacking it (see UCombatHarness). The game runs at a fixed
+ *  timestep for DurationSeconds of game time, then the report is written as JSON and the game exits.
+ * The report has frame and game thread time percentiles, the time of every FSlashPerfCounters bucket and the memory
+ *  high-water marks.
+ *
+ * Usage: UnrealEditor-Cmd Slash.uproject /Game/Maps/BenchmarkMap -game -nullrhi -nosound -unattended -SlashBenchmark
+ *  [-BenchmarkEnemies=N] [-BenchmarkSeconds=M] [-BenchmarkOutput=Path.json]
+ * Running it for several N gives the scaling curve. Defaults live in DefaultGame.ini under
+ *  [/Script/Slash.CombatBenchmarkSubsystem], the enemy and stand-in classes under [/Script/Slash.CombatHarness].
+ *
+ * Budgets: the average time of every bucket is checked against BudgetFile (-BenchmarkBudget= overrides it). When
+ *  a bucket is over its budget by more than the file's threshold, the failures are logged and added to the report
+ *  and the game exits with code 2. A budget file that can't be used (missing, unreadable, no AverageMs) exits with
+ *  code 3, so a gate that didn't run is never a pass; so does a build without the perf counters (shipping). The default file is skipped, not failed, when it was made for
+ *  another number of enemies (scaling runs); one given with -BenchmarkBudget= must match.
+ * With -BenchmarkCsv, a CSV profile of the recorded frames is captured too.
+ */
+UCLASS(Config = Game)
+class SLASH_API UCombatBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** <UWorldSubsystem> */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	/** </UWorldSubsystem> */
+
+	/** <UTickableWorldSubsystem> */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+	/** </UTickableWorldSubsystem> */
+
+	FORCEINLINE bool IsRunning() const { return bRunning; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void SpawnEnemies();
+
+	void RecordFrame();
+	void Finish();
+	/**
+	* False if the budget file couldn't be used (missing, unreadable, or made for another number of enemies when it
+	*  was asked for with -BenchmarkBudget=). bOutChecked is true when the buckets were compared to it.
+	*/
+	bool CheckBudgets(TArray<FString>& OutFailures, bool& bOutChecked) const;
+	bool WriteReport(const FString& Path, const TArray<FString>& BudgetFailures, bool bBudgetChecked) const;
+
+	// -BenchmarkEnemies= overrides it
+	UPROPERTY(Config)
+	int32 NumEnemies = 20;
+
+	// Game time, -BenchmarkSeconds= overrides it
+	UPROPERTY(Config)
+	float DurationSeconds = 60.f;
+
+	UPROPERTY(Config)
+	float FixedFrameRate = 30.f;
+
+	// Frames not recorded at the start, while everything spawns and settles
+	UPROPERTY(Config)
+	int32 WarmupFrames = 60;
+
+	UPROPERTY(Config)
+	float SpawnRadius = 1500.f;
+
+	UPROPERTY(Config)
+	float StandInAttackRange = 150.f;
+
+	// Relative to the project directory
+	UPROPERTY(Config)
+	FString BudgetFile = TEXT("Config/PerfBudgets/CombatBenchmark.json");
+
+	// Memory is sampled every this many frames (reading it isn't free on every platform)
+	UPROPERTY(Config)
+	int32 MemorySampleInterval = 30;
+
+	UPROPERTY()
+	TObjectPtr<UCombatHarness> Harness;
+
+	FString OutputPath;
+	FString BudgetPath;
+	bool bRunning = false;
+	bool bCaptureCsv = false;
+	bool bBudgetRequested = false;
+
+	int32 NumFrames = 0;
+	int32 NumRecordedFrames = 0;
+	double LastFrameTime = 0.0;
+
+	/** One entry per recorded frame */
+	TArray<float> FrameMs;
+	TArray<float> GameThreadMs;
+
+	double BucketTotalMs[static_cast<uint8>(ESlashPerfBucket::SPB_MAX)] = {};
+	int64 TotalDamageEvents = 0;
+
+	uint64 PeakUsedPhysical = 0;
+	uint64 PeakUsedVirtual = 0;
+};
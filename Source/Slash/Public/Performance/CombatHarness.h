@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "CombatHarness.generated.h"
+
+class AEnemy;
+class ASlashCharacter;
+class AWeapon;
+class FJsonObject;
+
+/**
+ * The fight shared by the combat benchmark (UCombatBenchmarkSubsystem) and the combat simulation commandlet
+ *  (UCombatSimCommandlet): enemies spawned in rings around an AI-possessed Echo stand-in, which keeps attacking the
+ *  closest one. Dead enemies and a dead stand-in are replaced, so the fight never ends.
+ * The Blueprint classes live in DefaultGame.ini under [/Script/Slash.CombatHarness], for both.
+ */
+UCLASS(Config = Game)
+class SLASH_API UCombatHarness : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Loads every class up front (so loading isn't measured), false with an error logged if one is missing */
+	bool LoadClasses();
+
+	/**
+	* Spawns the enemies missing from the NumEnemies slots: rings of EnemiesPerRing around the origin, facing it, the
+	*  first one Radius away and each next one RingSpacing further.
+	*/
+	void SpawnEnemies(UWorld* World, int32 NumEnemies, float Radius, int32 EnemiesPerRing, float RingSpacing);
+
+	/**
+	* Respawns the stand-in if it's dead, otherwise attacks the closest enemy. The stand-in walks to an enemy further
+	*  than AttackRange first; with an AttackRange of 0 (no navmesh) it only turns to it.
+	*/
+	void DriveStandIn(UWorld* World, float AttackRange);
+
+	/** Forgets the combatants, before their world is destroyed */
+	void Reset();
+
+	/** Average, P50, P90, P95, P99 and Max of the samples */
+	static TSharedRef<FJsonObject> MakeDistribution(TArray<float> Samples);
+
+	FORCEINLINE void SetOrigin(const FVector& InOrigin) { Origin = InOrigin; }
+	FORCEINLINE int32 GetNumEnemiesSpawned() const { return NumEnemiesSpawned; }
+	FORCEINLINE int32 GetNumStandInDeaths() const { return NumStandInDeaths; }
+
+private:
+	void SpawnStandIn(UWorld* World);
+	AEnemy* FindClosestEnemy(const FVector& Location) const;
+
+	UPROPERTY(Config)
+	TArray<TSoftClassPtr<AEnemy>> EnemyClasses;
+
+	UPROPERTY(Config)
+	TSoftClassPtr<ASlashCharacter> StandInClass;
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AWeapon> StandInWeaponClass;
+
+	UPROPERTY()
+	TArray<TObjectPtr<AEnemy>> Enemies;
+
+	UPROPERTY()
+	TObjectPtr<ASlashCharacter> StandIn;
+
+	FVector Origin = FVector::ZeroVector;
+	int32 NumEnemiesSpawned = 0;
+	int32 NumStandInDeaths = 0;
+};
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Low Level Memory tracker tags of the Slash module, children of the Slash tag so they show as Slash/Enemies etc. in
+ *  "stat LLMFULL" and LLM CSV captures (run with -llm), and Slash is their total. Allocations get a tag with LLM_SCOPE_BYTAG(Slash_Enemies) etc. around the code that makes them:
+ *  constructors (components), BeginPlay (widgets, spawned weapons) and the places that spawn the actors.
+ * Everything compiles to nothing when LLM is disabled (shipping builds by default).
+ *
+ * Bytes per actor class are printed by the console command Slash.MemReport.
+ */
+LLM_DECLARE_TAG_API(Slash, SLASH_API);
+LLM_DECLARE_TAG_API(Slash_Enemies, SLASH_API);
+LLM_DECLARE_TAG_API(Slash_Weapons, SLASH_API);
+LLM_DECLARE_TAG_API(Slash_Pickups, SLASH_API);
+LLM_DECLARE_TAG_API(Slash_Breakables, SLASH_API);
+LLM_DECLARE_TAG_API(Slash_HUD, SLASH_API);
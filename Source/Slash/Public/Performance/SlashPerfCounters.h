@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Performance/SlashStats.h"
+#include "Performance/SlashTrace.h"
+
+/** Counters are compiled out of shipping builds */
+#define SLASH_PERF_COUNTERS !UE_BUILD_SHIPPING
+
+/** What the game thread time is spent on */
+enum class ESlashPerfBucket : uint8
+{
+	SPB_AI,
+	SPB_Combat,
+	SPB_Pickups,
+	SPB_Items,
+	SPB_HUD,
+	SPB_FX,
+	SPB_Debris,
+	SPB_Animation,
+
+	SPB_MAX
+};
+
+/**
+ * Game thread counters of the Slash systems, read by the HUD perf overlay (Slash.PerfOverlay 1) and the combat
+ *  benchmark, and written to CSV profiles (categories SlashAI, SlashCombat...) while a capture runs.
+ * Time is added with SLASH_SCOPE(Bucket, Name) in the code of each system; everything is reset at the end of
+ *  every frame, keeping the last frame's values (and a smoothed average of the times) to display.
+ * Game thread only.
+ */
+class SLASH_API FSlashPerfCounters
+{
+public:
+	static FSlashPerfCounters& Get();
+
+	FORCEINLINE void AddCycles(ESlashPerfBucket Bucket, uint64 Cycles) { CurrentCycles[static_cast<uint8>(Bucket)] += Cycles; }
+	FORCEINLINE void AddDamageEvent() { ++CurrentDamageEvents; }
+
+	/** Average game thread milliseconds per frame */
+	double GetBucketMs(ESlashPerfBucket Bucket) const { return AverageMs[static_cast<uint8>(Bucket)]; }
+	double GetBucketMsLastFrame(ESlashPerfBucket Bucket) const { return LastFrameMs[static_cast<uint8>(Bucket)]; }
+	int32 GetDamageEventsLastFrame() const { return LastDamageEvents; }
+
+	static const TCHAR* GetBucketName(ESlashPerfBucket Bucket);
+
+private:
+	FSlashPerfCounters();
+	void EndFrame();
+
+	uint64 CurrentCycles[static_cast<uint8>(ESlashPerfBucket::SPB_MAX)] = {};
+	double AverageMs[static_cast<uint8>(ESlashPerfBucket::SPB_MAX)] = {};
+	double LastFrameMs[static_cast<uint8>(ESlashPerfBucket::SPB_MAX)] = {};
+
+	int32 CurrentDamageEvents = 0;
+	int32 LastDamageEvents = 0;
+};
+
+#if SLASH_PERF_COUNTERS
+
+/**
+ * Adds the time spent in its scope to a bucket.
+ * Scopes nest without counting twice: while an inner scope runs (e.g. FX spawned by a hit), the outer one is paused.
+ */
+class SLASH_API FSlashPerfScope
+{
+public:
+	explicit FSlashPerfScope(ESlashPerfBucket InBucket);
+	~FSlashPerfScope();
+
+private:
+	ESlashPerfBucket Bucket;
+	uint64 StartCycles;
+	FSlashPerfScope* Parent;
+
+	static FSlashPerfScope* Current;
+};
+
+#define SLASH_PERF_SCOPE(Bucket) FSlashPerfScope ANONYMOUS_VARIABLE(SlashPerfScope)(ESlashPerfBucket::Bucket)
+#define SLASH_PERF_DAMAGE_EVENT() do { FSlashPerfCounters::Get().AddDamageEvent(); INC_DWORD_STAT(STAT_SlashDamageEvents); } while (0)
+
+#else
+
+#define SLASH_PERF_SCOPE(Bucket)
+#define SLASH_PERF_DAMAGE_EVENT()
+
+#endif
+
+/**
+ * The one scope to put on gameplay code: adds its time to the Bucket of the perf overlay and benchmark, to the cycle
+ *  stat STAT_Slash<Name> of "stat Slash" (DECLARE_CYCLE_STAT it in the .cpp) and to an Unreal Insights CPU scope
+ *  Slash<Name> on the Slash trace channel. So the three always measure the same code.
+ * Game thread only: the perf counters aren't thread safe, use SCOPE_CYCLE_COUNTER alone on worker threads.
+ */
+#define SLASH_SCOPE(Bucket, Name) \
+	SLASH_PERF_SCOPE(Bucket); \
+	SCOPE_CYCLE_COUNTER(STAT_Slash##Name); \
+	SLASH_TRACE_SCOPE(Slash##Name)
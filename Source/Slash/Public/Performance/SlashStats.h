@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/**
+ * "stat Slash": where the game thread time of our gameplay code goes.
+ * Cycle stats are declared next to the code they measure (DECLARE_CYCLE_STAT in each .cpp) and timed with
+ *  SLASH_SCOPE(Bucket, Name), the per frame counters shared by many files are declared here. Like every stat, all
+ *  of it compiles out of shipping builds.
+ */
+DECLARE_STATS_GROUP(TEXT("Slash"), STATGROUP_Slash, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces"), STAT_SlashTraces, STATGROUP_Slash, SLASH_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spawns"), STAT_SlashSpawns, STATGROUP_Slash, SLASH_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Damage Events"), STAT_SlashDamageEvents, STATGROUP_Slash, SLASH_API);
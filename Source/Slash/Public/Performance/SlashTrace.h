@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+class UFXSystemComponent;
+
+/**
+ * Unreal Insights support for Slash: run with -trace=cpu,bookmark,counters,slash (or "Trace.Enable slash").
+ * - CPU scopes on the gameplay code, from SLASH_SCOPE(Bucket, Name) (see SlashPerfCounters.h)
+ * - Bookmarks for gameplay events (enemy state changes, hits, deaths, spawns), with SLASH_TRACE_BOOKMARK
+ * - Counters for live enemies, pickups and FX, under "Slash/"
+ * Scopes and bookmarks only cost a branch while the channel is off. Compiled out of shipping builds.
+ */
+#define SLASH_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if SLASH_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(SlashChannel, SLASH_API);
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(SlashLiveEnemies);
+TRACE_DECLARE_INT_COUNTER_EXTERN(SlashPickups);
+TRACE_DECLARE_INT_COUNTER_EXTERN(SlashInstancedPickups);
+TRACE_DECLARE_INT_COUNTER_EXTERN(SlashActiveFX);
+
+/** Keeps the count of the FX we spawn that are still playing, for the Slash/ActiveFX counter */
+class SLASH_API FSlashTrace
+{
+public:
+	static void TrackFX(UFXSystemComponent* FX);
+
+private:
+	static void EndFrame();
+
+	static TArray<TWeakObjectPtr<UFXSystemComponent>> ActiveFX;
+	static bool bEndFrameBound;
+};
+
+#define SLASH_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Name, SlashChannel)
+#define SLASH_TRACE_BOOKMARK(Format, ...) \
+	do { if (UE_TRACE_CHANNELEXPR_IS_ENABLED(SlashChannel)) { TRACE_BOOKMARK(Format, ##__VA_ARGS__); } } while (0)
+#define SLASH_TRACE_COUNTER_SET(Counter, Value) TRACE_COUNTER_SET(Counter, Value)
+#define SLASH_TRACE_COUNTER_INCREMENT(Counter) TRACE_COUNTER_INCREMENT(Counter)
+#define SLASH_TRACE_COUNTER_DECREMENT(Counter) TRACE_COUNTER_DECREMENT(Counter)
+#define SLASH_TRACE_FX(FX) FSlashTrace::TrackFX(FX)
+
+#else
+
+#define SLASH_TRACE_SCOPE(Name)
+#define SLASH_TRACE_BOOKMARK(Format, ...)
+#define SLASH_TRACE_COUNTER_SET(Counter, Value)
+#define SLASH_TRACE_COUNTER_INCREMENT(Counter)
+#define SLASH_TRACE_COUNTER_DECREMENT(Counter)
+#define SLASH_TRACE_FX(FX)
+
+#endif